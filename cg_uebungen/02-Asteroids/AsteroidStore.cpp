@@ -0,0 +1,191 @@
+#include "AsteroidStore.h"
+#include <algorithm>
+#include <cstring>
+#include "../framework/error.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+size_t AsteroidStore::add(const glm::vec2& position, const glm::vec2& velocity, float angle, Size sizeClass)
+{
+	// the collision queries rely on the speed limit
+	dassert(glm::length(velocity) <= maxSpeed[sizeClass]);
+
+	positionX.push_back(position.x);
+	positionY.push_back(position.y);
+	velocityX.push_back(velocity.x);
+	velocityY.push_back(velocity.y);
+	rotation.push_back(angle);
+	previousX.push_back(position.x);
+	previousY.push_back(position.y);
+	previousRotation.push_back(angle);
+	size.push_back(sizeClass);
+	alive.push_back(1);
+	return count() - 1;
+}
+
+void AsteroidStore::clear()
+{
+	positionX.clear();
+	positionY.clear();
+	velocityX.clear();
+	velocityY.clear();
+	rotation.clear();
+	previousX.clear();
+	previousY.clear();
+	previousRotation.clear();
+	size.clear();
+	alive.clear();
+}
+
+void AsteroidStore::storePrevious(size_t first, size_t last)
+{
+	std::copy(positionX.begin() + first, positionX.begin() + last, previousX.begin() + first);
+	std::copy(positionY.begin() + first, positionY.begin() + last, previousY.begin() + first);
+	std::copy(rotation.begin() + first, rotation.begin() + last, previousRotation.begin() + first);
+}
+
+void AsteroidStore::integrate(float dt, size_t first, size_t last)
+{
+	size_t i = first;
+
+#ifdef __AVX2__
+	const __m256 vdt = _mm256_set1_ps(dt);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 signBit = _mm256_set1_ps(-0.0f);
+	// lookup tables in the lower lanes (indexed by the size class)
+	const __m256 speedTable = _mm256_setr_ps(rotationSpeed[0], rotationSpeed[1], rotationSpeed[2], 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+	const __m256 limitTable = _mm256_setr_ps(1.0f + radius[0], 1.0f + radius[1], 1.0f + radius[2], 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+
+	for (; i + 8 <= last; i += 8)
+	{
+		const __m256i sizes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&size[i])));
+		const __m256 speed = _mm256_permutevar8x32_ps(speedTable, sizes);
+		const __m256 limit = _mm256_permutevar8x32_ps(limitTable, sizes);
+
+		const __m256 vx = _mm256_loadu_ps(&velocityX[i]);
+		const __m256 vy = _mm256_loadu_ps(&velocityY[i]);
+		__m256 px = _mm256_add_ps(_mm256_loadu_ps(&positionX[i]), _mm256_mul_ps(vx, vdt));
+		__m256 py = _mm256_add_ps(_mm256_loadu_ps(&positionY[i]), _mm256_mul_ps(vy, vdt));
+		const __m256 rot = _mm256_add_ps(_mm256_loadu_ps(&rotation[i]), _mm256_mul_ps(vdt, speed));
+
+		// wrap: position * sign(velocity) > 1 + radius => position = -position
+		const __m256 wrapX = _mm256_or_ps(
+			_mm256_and_ps(_mm256_cmp_ps(vx, zero, _CMP_GT_OQ), _mm256_cmp_ps(px, limit, _CMP_GT_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(vx, zero, _CMP_LT_OQ), _mm256_cmp_ps(_mm256_xor_ps(px, signBit), limit, _CMP_GT_OQ)));
+		const __m256 wrapY = _mm256_or_ps(
+			_mm256_and_ps(_mm256_cmp_ps(vy, zero, _CMP_GT_OQ), _mm256_cmp_ps(py, limit, _CMP_GT_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(vy, zero, _CMP_LT_OQ), _mm256_cmp_ps(_mm256_xor_ps(py, signBit), limit, _CMP_GT_OQ)));
+		px = _mm256_xor_ps(px, _mm256_and_ps(wrapX, signBit));
+		py = _mm256_xor_ps(py, _mm256_and_ps(wrapY, signBit));
+
+		_mm256_storeu_ps(&positionX[i], px);
+		_mm256_storeu_ps(&positionY[i], py);
+		_mm256_storeu_ps(&rotation[i], rot);
+	}
+#endif
+
+	integrateScalar(i, last, dt);
+}
+
+void AsteroidStore::integrateScalar(size_t first, size_t last, float dt)
+{
+	for (size_t i = first; i < last; ++i)
+	{
+		positionX[i] += velocityX[i] * dt;
+		positionY[i] += velocityY[i] * dt;
+		rotation[i] += dt * rotationSpeed[size[i]];
+
+		const float limit = 1.0f + radius[size[i]];
+		if (positionX[i] * glm::sign(velocityX[i]) > limit)
+			positionX[i] = -positionX[i];
+		if (positionY[i] * glm::sign(velocityY[i]) > limit)
+			positionY[i] = -positionY[i];
+	}
+}
+
+void AsteroidStore::eraseDead()
+{
+	size_t i = 0;
+	while (i < count())
+	{
+		if (alive[i])
+			++i;
+		else
+			moveLast(i); // test the moved one in the next iteration
+	}
+}
+
+template<class T>
+static uint8_t* saveArray(const std::vector<T>& v, uint8_t* dst)
+{
+	const size_t bytes = v.size() * sizeof(T);
+	if (bytes)
+		memcpy(dst, v.data(), bytes);
+	return dst + bytes;
+}
+
+template<class T>
+static const uint8_t* loadArray(std::vector<T>& v, size_t n, const uint8_t* src)
+{
+	v.resize(n);
+	const size_t bytes = n * sizeof(T);
+	if (bytes)
+		memcpy(v.data(), src, bytes);
+	return src + bytes;
+}
+
+uint8_t* AsteroidStore::saveTo(uint8_t* dst) const
+{
+	dst = saveArray(positionX, dst);
+	dst = saveArray(positionY, dst);
+	dst = saveArray(velocityX, dst);
+	dst = saveArray(velocityY, dst);
+	dst = saveArray(rotation, dst);
+	dst = saveArray(previousX, dst);
+	dst = saveArray(previousY, dst);
+	dst = saveArray(previousRotation, dst);
+	dst = saveArray(size, dst);
+	return saveArray(alive, dst);
+}
+
+const uint8_t* AsteroidStore::loadFrom(const uint8_t* src, size_t n)
+{
+	src = loadArray(positionX, n, src);
+	src = loadArray(positionY, n, src);
+	src = loadArray(velocityX, n, src);
+	src = loadArray(velocityY, n, src);
+	src = loadArray(rotation, n, src);
+	src = loadArray(previousX, n, src);
+	src = loadArray(previousY, n, src);
+	src = loadArray(previousRotation, n, src);
+	src = loadArray(size, n, src);
+	return loadArray(alive, n, src);
+}
+
+void AsteroidStore::moveLast(size_t i)
+{
+	const size_t last = count() - 1;
+	positionX[i] = positionX[last];
+	positionY[i] = positionY[last];
+	velocityX[i] = velocityX[last];
+	velocityY[i] = velocityY[last];
+	rotation[i] = rotation[last];
+	previousX[i] = previousX[last];
+	previousY[i] = previousY[last];
+	previousRotation[i] = previousRotation[last];
+	size[i] = size[last];
+	alive[i] = alive[last];
+
+	positionX.pop_back();
+	positionY.pop_back();
+	velocityX.pop_back();
+	velocityY.pop_back();
+	rotation.pop_back();
+	previousX.pop_back();
+	previousY.pop_back();
+	previousRotation.pop_back();
+	size.pop_back();
+	alive.pop_back();
+}
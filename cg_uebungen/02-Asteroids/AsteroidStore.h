@@ -0,0 +1,83 @@
+#pragma once
+#include "../framework/glmmath.h"
+#include <vector>
+#include <cstdint>
+#include <array>
+
+/// \brief asteroids of all sizes in structure of arrays layout
+struct AsteroidStore
+{
+	enum Size : uint8_t
+	{
+		BIG = 0,
+		MID = 1,
+		SMALL = 2,
+		NUM_SIZES
+	};
+
+	// per size lookup tables
+	static constexpr std::array<float, NUM_SIZES> radius = { 0.1f, 0.06f, 0.035f };
+	static constexpr std::array<float, NUM_SIZES> rotationSpeed = { 0.0003f, 0.0006f, 0.0012f };
+	// upper bound of the speed (new asteroids get up to 0.0006, split asteroids add 0.75 * parent speed)
+	static constexpr std::array<float, NUM_SIZES> maxSpeed = { 0.0006f, 0.00106f, 0.0014f };
+
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> velocityX;
+	std::vector<float> velocityY;
+	std::vector<float> rotation;
+	// state of the previous update (for render interpolation)
+	std::vector<float> previousX;
+	std::vector<float> previousY;
+	std::vector<float> previousRotation;
+	std::vector<uint8_t> size;
+	std::vector<uint8_t> alive;
+
+	/// \return number of asteroids (including dead ones until eraseDead())
+	size_t count() const { return positionX.size(); }
+
+	bool empty() const { return positionX.empty(); }
+
+	glm::vec2 getPosition(size_t i) const { return glm::vec2(positionX[i], positionY[i]); }
+	glm::vec2 getVelocity(size_t i) const { return glm::vec2(velocityX[i], velocityY[i]); }
+	glm::vec2 getPreviousPosition(size_t i) const { return glm::vec2(previousX[i], previousY[i]); }
+
+	/// \brief appends a new alive asteroid
+	/// \return index of the asteroid
+	size_t add(const glm::vec2& position, const glm::vec2& velocity, float angle, Size sizeClass);
+
+	/// \brief removes all asteroids
+	void clear();
+
+	/// \brief copies the current positions and rotations of [first, last) into the previous state
+	void storePrevious(size_t first, size_t last);
+
+	/// \brief moves and rotates the asteroids [first, last) and wraps them around the screen (see Game::clipObject).
+	/// Disjoint ranges can be integrated in parallel
+	/// \param dt time delta in milliseconds
+	void integrate(float dt, size_t first, size_t last);
+
+	/// \brief removes all dead asteroids (swap and pop, changes the order)
+	void eraseDead();
+
+	// bytes per asteroid that saveTo() writes
+	static constexpr size_t SNAPSHOT_BYTES = 8 * sizeof(float) + 2 * sizeof(uint8_t);
+
+	/// \return number of bytes that saveTo() writes
+	size_t getSnapshotSize() const { return count() * SNAPSHOT_BYTES; }
+
+	/// \brief copies all arrays to dst
+	/// \return end of the written data
+	uint8_t* saveTo(uint8_t* dst) const;
+
+	/// \brief replaces all asteroids with the data of saveTo()
+	/// \param n number of asteroids in src
+	/// \return end of the read data
+	const uint8_t* loadFrom(const uint8_t* src, size_t n);
+private:
+	/// \brief scalar version of integrate() for the range [first, last)
+	void integrateScalar(size_t first, size_t last, float dt);
+
+	/// \brief moves the last asteroid to index i and removes the last one
+	void moveLast(size_t i);
+};
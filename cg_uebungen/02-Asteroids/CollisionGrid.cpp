@@ -0,0 +1,73 @@
+#include "CollisionGrid.h"
+#include <cmath>
+
+CollisionGrid::CollisionGrid(float cellSize, float extent)
+	:
+	m_extent(extent),
+	m_invCellSize(1.0f / cellSize),
+	m_cellsPerAxis(std::max(1, int(std::ceil(2.0f * extent / cellSize))))
+{
+	m_cellStart.assign(size_t(m_cellsPerAxis * m_cellsPerAxis) + 1, 0);
+}
+
+void CollisionGrid::clear()
+{
+	// keeps the heap storage
+	m_cells.clear();
+	m_sorted.clear();
+	m_late.clear();
+	std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+}
+
+void CollisionGrid::build(const float* positionX, const float* positionY, size_t count, ThreadPool& pool)
+{
+	// minimum number of objects per chunk
+	const size_t minChunkSize = 4096;
+
+	m_late.clear();
+	m_cells.resize(count);
+	m_sorted.resize(count);
+
+	const size_t numCells = m_cellStart.size() - 1;
+	const size_t numChunks = std::max<size_t>(pool.getChunkCount(count, minChunkSize), 1);
+	m_chunkOffsets.assign(numChunks * numCells, 0);
+
+	// find cells and count objects per cell in every chunk
+	pool.parallelFor(count, minChunkSize, [&](size_t chunk, size_t first, size_t last)
+		{
+			uint32_t* counts = &m_chunkOffsets[chunk * numCells];
+			for (size_t i = first; i < last; ++i)
+			{
+				const uint32_t cell = uint32_t(cellCoord(positionY[i]) * m_cellsPerAxis + cellCoord(positionX[i]));
+				m_cells[i] = cell;
+				++counts[cell];
+			}
+		});
+
+	// prefix sum in (cell, chunk) order => start of every cell and the start of every chunk inside the cell
+	uint32_t sum = 0;
+	for (size_t cell = 0; cell < numCells; ++cell)
+	{
+		m_cellStart[cell] = sum;
+		for (size_t chunk = 0; chunk < numChunks; ++chunk)
+		{
+			const uint32_t n = m_chunkOffsets[chunk * numCells + cell];
+			m_chunkOffsets[chunk * numCells + cell] = sum;
+			sum += n;
+		}
+	}
+	m_cellStart[numCells] = sum;
+
+	// scatter ids (same order as a serial counting sort)
+	pool.parallelFor(count, minChunkSize, [&](size_t chunk, size_t first, size_t last)
+		{
+			uint32_t* cursor = &m_chunkOffsets[chunk * numCells];
+			for (size_t i = first; i < last; ++i)
+				m_sorted[cursor[m_cells[i]]++] = uint32_t(i);
+		});
+}
+
+void CollisionGrid::insert(uint32_t id)
+{
+	m_late.push_back(id);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "../framework/glmmath.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "../framework/ThreadPool.h"
+
+/// \brief uniform grid for broadphase collision queries. The grid is rebuilt every tick in linear time.
+/// Positions outside of the grid area are clamped into the border cells, so objects that left the
+/// screen (before clipObject wraps them) are still found.
+class CollisionGrid
+{
+public:
+	/// \param cellSize edge length of a cell
+	/// \param extent the grid covers [-extent, extent] on both axes
+	CollisionGrid(float cellSize, float extent);
+
+	/// \brief removes all objects
+	void clear();
+
+	/// \brief sorts objects into the cells (stable counting sort, parallel over chunks of objects).
+	/// The result does not depend on the thread count
+	/// \param positionX x coordinates of the objects (the id is the index)
+	/// \param positionY y coordinates of the objects
+	/// \param count number of objects
+	/// \param pool worker threads
+	void build(const float* positionX, const float* positionY, size_t count, ThreadPool& pool);
+
+	/// \brief adds an object after build() (e.g. objects that are spawned during the collision tests).
+	/// Late objects are visited by every query and should be rare
+	/// \param id object id (passed to the query callback)
+	void insert(uint32_t id);
+
+	/// \brief calls visit(id) for all objects in cells that overlap the square around position.
+	/// The order of the visited ids is unspecified
+	/// \param position query center
+	/// \param radius maximum distance of interest
+	template<class TVisitor>
+	void query(const glm::vec2& position, float radius, TVisitor&& visit) const
+	{
+		const int x0 = cellCoord(position.x - radius);
+		const int x1 = cellCoord(position.x + radius);
+		const int y0 = cellCoord(position.y - radius);
+		const int y1 = cellCoord(position.y + radius);
+
+		for (int y = y0; y <= y1; ++y)
+		{
+			for (int x = x0; x <= x1; ++x)
+			{
+				const size_t cell = size_t(y * m_cellsPerAxis + x);
+				for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+					visit(m_sorted[i]);
+			}
+		}
+
+		for (const auto& late : m_late)
+			visit(late);
+	}
+private:
+	/// \return cell coordinate of a position component (clamped to the grid)
+	int cellCoord(float v) const
+	{
+		return std::min(std::max(int((v + m_extent) * m_invCellSize), 0), m_cellsPerAxis - 1);
+	}
+private:
+	float m_extent;
+	float m_invCellSize;
+	int m_cellsPerAxis;
+
+	// cell of every object
+	std::vector<uint32_t> m_cells;
+	// object count per (chunk, cell) and later the write cursor of the chunk in the cell
+	std::vector<uint32_t> m_chunkOffsets;
+	// cell ranges in m_sorted (m_cellStart[cell] to m_cellStart[cell + 1])
+	std::vector<uint32_t> m_cellStart;
+	std::vector<uint32_t> m_sorted;
+	// objects inserted after build()
+	std::vector<uint32_t> m_late;
+};
@@ -2,59 +2,124 @@
 
 #include <array>
 #include <random>
+#include <cstring>
+#include <type_traits>
 
 using namespace glm;
 
-void Game::draw(Pipeline& gfx) const
+struct Game::SnapshotHeader
 {
-	// draw missles
-	gfx.setVertexScale(m_missleRadius);
-	for (const auto& m : m_missles)
-	{
-		gfx.setVertexRotation(m.rotation);
-		gfx.setVertexTranslation(m.position);
-		gfx.drawTriangleList(m_missleMesh);
-	}
+	uint8_t twister[sizeof(std::mt19937)];
+	decltype(Game::m_missles) missles;
+	uint64_t asteroidCount;
+
+	int currentLevel;
+	int asteroidsPerLevel;
+	int score;
+	bool gameOver;
+	float totalTime;
+	float missleReloadTime;
+
+	glm::vec2 shipPosition;
+	glm::vec2 shipVelocity;
+	float shipRotation;
+	glm::vec2 previousShipPosition;
+	float previousShipRotation;
+
+	bool leftKeyDown;
+	bool rightKeyDown;
+	bool upKeyDown;
+	bool fireDown;
+	bool warpRequest;
+};
 
-	// draw asteroids
-	gfx.setVertexScale(m_bigAsteroidRadius);
-	for (const auto& a : m_bigAsteroids)
-	{
-		gfx.setVertexRotation(a.rotation);
-		gfx.setVertexTranslation(a.position);
-		gfx.drawTriangleList(m_bigAsteroidMesh);
-	}
+// the random engine is stored as raw bytes
+static_assert(std::is_trivially_copyable<std::mt19937>::value, "the random engine must be trivially copyable");
 
-	gfx.setVertexScale(m_midAsteroidRadius);
-	for (const auto& a : m_midAsteroids)
-	{
-		gfx.setVertexRotation(a.rotation);
-		gfx.setVertexTranslation(a.position);
-		gfx.drawTriangleList(m_midAsteroidMesh);
-	}
+void Game::saveSnapshot(GameSnapshot& snapshot) const
+{
+	static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "the snapshot header is copied with memcpy");
+
+	// clear the padding as well (snapshots are compared bytewise, aggregate initialization leaves it unspecified)
+	SnapshotHeader h;
+	memset(static_cast<void*>(&h), 0, sizeof(h));
+	memcpy(h.twister, &m_twister, sizeof(std::mt19937));
+	h.missles = m_missles;
+	h.asteroidCount = m_asteroids.count();
+	h.currentLevel = m_currentLevel;
+	h.asteroidsPerLevel = m_asteroidsPerLevel;
+	h.score = m_score;
+	h.gameOver = m_gameOver;
+	h.totalTime = m_totalTime;
+	h.missleReloadTime = m_missleReloadTime;
+	h.shipPosition = m_shipPosition;
+	h.shipVelocity = m_shipVelocity;
+	h.shipRotation = m_shipRotation;
+	h.previousShipPosition = m_previousShipPosition;
+	h.previousShipRotation = m_previousShipRotation;
+	h.leftKeyDown = m_leftKeyDown;
+	h.rightKeyDown = m_rightKeyDown;
+	h.upKeyDown = m_upKeyDown;
+	h.fireDown = m_fireDown;
+	h.warpRequest = m_warpRequest;
+
+	uint8_t* dst = snapshot.resize(sizeof(SnapshotHeader) + m_asteroids.getSnapshotSize());
+	memcpy(dst, &h, sizeof(SnapshotHeader));
+	m_asteroids.saveTo(dst + sizeof(SnapshotHeader));
+}
 
-	gfx.setVertexScale(m_smallAsteroidRadius);
-	for (const auto& a : m_smallAsteroids)
-	{
-		gfx.setVertexRotation(a.rotation);
-		gfx.setVertexTranslation(a.position);
-		gfx.drawTriangleList(m_smallAsteroidMesh);
-	}
+void Game::loadSnapshot(const GameSnapshot& snapshot)
+{
+	dassert(snapshot.getSize() >= sizeof(SnapshotHeader));
+	SnapshotHeader h;
+	memcpy(&h, snapshot.data(), sizeof(SnapshotHeader));
+
+	memcpy(&m_twister, h.twister, sizeof(std::mt19937));
+	m_missles = h.missles;
+	m_currentLevel = h.currentLevel;
+	m_asteroidsPerLevel = h.asteroidsPerLevel;
+	m_score = h.score;
+	m_gameOver = h.gameOver;
+	m_totalTime = h.totalTime;
+	m_missleReloadTime = h.missleReloadTime;
+	m_shipPosition = h.shipPosition;
+	m_shipVelocity = h.shipVelocity;
+	m_shipRotation = h.shipRotation;
+	m_previousShipPosition = h.previousShipPosition;
+	m_previousShipRotation = h.previousShipRotation;
+	m_leftKeyDown = h.leftKeyDown;
+	m_rightKeyDown = h.rightKeyDown;
+	m_upKeyDown = h.upKeyDown;
+	m_fireDown = h.fireDown;
+	m_warpRequest = h.warpRequest;
+	// particles are not part of the snapshot, the ones of the discarded timeline would be left behind
+	m_particles.clear();
+
+	m_asteroids.loadFrom(snapshot.data() + sizeof(SnapshotHeader), size_t(h.asteroidCount));
+	dassert(snapshot.getSize() == sizeof(SnapshotHeader) + m_asteroids.getSnapshotSize());
+}
 
-	// draw ship
-	gfx.setVertexScale(m_shipRadius);
-	gfx.setVertexRotation(m_shipRotation);
-	gfx.setVertexTranslation(m_shipPosition);
+size_t Game::getSnapshotSize(size_t asteroidCount)
+{
+	return sizeof(SnapshotHeader) + asteroidCount * AsteroidStore::SNAPSHOT_BYTES;
+}
+
+void Game::setThreadCount(size_t count)
+{
+	m_threadPool = std::make_unique<ThreadPool>(count);
+}
 
-	//Draw fire
-	if (m_upKeyDown && !m_gameOver)
+void Game::setSpriteCache(size_t rotations, size_t maxBytes)
+{
+	if (rotations == 0)
 	{
-		gfx.setFragmentScale(0.5f + 0.5f * sin(m_totalTime * 0.04f));
-		gfx.drawTriangleList(m_shipFireMesh);
-		gfx.setFragmentScale(1.0f);
+		m_spriteCache.reset();
+		return;
 	}
 
-	gfx.drawTriangleList(m_shipMesh);
+	m_spriteCache = std::make_unique<SpriteCache>(rotations, maxBytes);
+	for (int size = 0; size < AsteroidStore::NUM_SIZES; ++size)
+		m_asteroidSprites[size] = m_spriteCache->addMesh(m_asteroidMeshes[size].front().triangles, AsteroidStore::radius[size]);
 }
 
 void Game::generateShipMesh()
@@ -172,9 +237,10 @@ static const std::array<int, 10 * 3> s_bigAsteroidIndices = {
 };
 
 template<size_t n_indices, size_t n_vertices>
-std::vector<Vertex> makeAsteroid(const std::array<int, n_indices>& indices, const std::array<vec2, n_vertices>& vertices)
+std::vector<MeshLod> makeAsteroid(const std::array<int, n_indices>& indices, const std::array<vec2, n_vertices>& vertices)
 {
-	std::vector<Vertex> list;
+	std::vector<MeshLod> lods(1);
+	std::vector<Vertex>& list = lods.front().triangles;
 
 	std::mt19937 twister;
 	twister.seed(n_indices);
@@ -189,115 +255,73 @@ std::vector<Vertex> makeAsteroid(const std::array<int, n_indices>& indices, cons
 		list.push_back(v);
 	}
 
-	return list;
+	// reduced versions for small screen sizes
+	auto reduced = makeOutlineLods(std::vector<vec2>(vertices.begin(), vertices.end()), unsigned(n_indices));
+	lods.insert(lods.end(), reduced.begin(), reduced.end());
+
+	return lods;
 }
 
-Game::Game(Window& window)
+Game::Game(InputSource& input, uint32_t seed)
 	:
-	m_twister(std::random_device()())
+	m_input(input),
+	m_twister(seed),
+	m_threadPool(std::make_unique<ThreadPool>(1)),
+	m_particles(s_maxParticles, seed + 1)
 {
 	// create meshs
-	m_bigAsteroidMesh = makeAsteroid(s_bigAsteroidIndices, s_bigAsteroidPoints);
-	m_midAsteroidMesh = makeAsteroid(s_medAsteroidIndices, s_medAsteroidPoints);
-	m_smallAsteroidMesh = makeAsteroid(s_smallAsteroidIndices, s_smallAsteroidPoints);
+	m_asteroidMeshes[AsteroidStore::BIG] = makeAsteroid(s_bigAsteroidIndices, s_bigAsteroidPoints);
+	m_asteroidMeshes[AsteroidStore::MID] = makeAsteroid(s_medAsteroidIndices, s_medAsteroidPoints);
+	m_asteroidMeshes[AsteroidStore::SMALL] = makeAsteroid(s_smallAsteroidIndices, s_smallAsteroidPoints);
 	generateShipMesh();
 	generateFireMesh();
 	generateMissleMesh();
 
 	// load level
 	nextLevel();
+}
 
-	// set keyboard controls
-	window.setKeyDownCallback([this](Window::Key key)
+void Game::update(float dt)
+{
+	// process keyboard inputs
+	const InputState input = m_input.poll();
+	m_leftKeyDown = input.left;
+	m_rightKeyDown = input.right;
+	m_upKeyDown = input.thrust;
+	m_fireDown = input.fire;
+	m_warpRequest = m_warpRequest || input.warp;
+
+	// keep the last state for the render interpolation
+	m_previousShipPosition = m_shipPosition;
+	m_previousShipRotation = m_shipRotation;
+	m_threadPool->parallelFor(m_asteroids.count(), s_asteroidChunkSize, [this](size_t, size_t first, size_t last)
 		{
-			switch (key)
-			{
-			case Window::Key::LEFT:
-			case Window::Key::A:
-				m_leftKeyDown = true;
-				break;
-			case Window::Key::RIGHT:
-			case Window::Key::D:
-				m_rightKeyDown = true;
-				break;
-			case Window::Key::UP:
-			case Window::Key::W:
-				m_upKeyDown = true;
-				break;
-			case Window::Key::DOWN:
-			case Window::Key::S:
-				m_warpRequest = true;
-				break;
-			case Window::Key::RIGHT_CONTROL:
-			case Window::Key::LEFT_CONTROL:
-			case Window::Key::SPACE:
-				m_fireDown = true;
-				break;
-			default:;
-			}
+			m_asteroids.storePrevious(first, last);
 		});
 
-	window.setKeyUpCallback([this](Window::Key key)
-		{
-			switch (key)
-			{
-			case Window::Key::LEFT:
-			case Window::Key::A:
-				m_leftKeyDown = false;
-				break;
-			case Window::Key::RIGHT:
-			case Window::Key::D:
-				m_rightKeyDown = false;
-				break;
-			case Window::Key::UP:
-			case Window::Key::W:
-				m_upKeyDown = false;
-				break;
-			case Window::Key::RIGHT_CONTROL:
-			case Window::Key::LEFT_CONTROL:
-			case Window::Key::SPACE:
-				m_fireDown = false;
-				break;
-			case Window::Key::BACKSPACE:
-				m_currentLevel = 0;
-				m_score = 0;
-				m_totalTime = 0.0f;
-				nextLevel();
-				break;
-			default:;
-			}
-		});
-}
+	if (input.reset)
+	{
+		m_currentLevel = 0;
+		m_score = 0;
+		m_totalTime = 0.0f;
+		m_particles.clear();
+		nextLevel();
+	}
+
+	// effects keep moving after the game is over
+	m_particles.update(dt);
 
-void Game::update(float dt)
-{
 	if (m_gameOver) return;
 
 	m_totalTime += dt;
 
 	// update asteroids
-	for (auto& a : m_bigAsteroids)
-	{
-		a.position += a.velocity * dt;
-		a.rotation += dt * 0.0003f;
-		clipObject(a.position, a.velocity, m_bigAsteroidRadius);
-	}
-
-	for (auto& a : m_midAsteroids)
-	{
-		a.position += a.velocity * dt;
-		a.rotation += dt * 0.0006f;
-		clipObject(a.position, a.velocity, m_midAsteroidRadius);
-	}
-
-	for (auto& a : m_smallAsteroids)
-	{
-		a.position += a.velocity * dt;
-		a.rotation += dt * 0.0012f;
-		clipObject(a.position, a.velocity, m_smallAsteroidRadius);
-	}
+	m_threadPool->parallelFor(m_asteroids.count(), s_asteroidChunkSize, [this, dt](size_t, size_t first, size_t last)
+		{
+			m_asteroids.integrate(dt, first, last);
+		});
 
-	// process keyboard inputs
+	// warp the ship
 	if (m_warpRequest)
 	{
 		m_warpRequest = false;
@@ -305,6 +329,7 @@ void Game::update(float dt)
 		auto posDist = std::uniform_real_distribution<float>(-0.9f, 0.9f);
 		m_shipPosition.x = posDist(m_twister);
 		m_shipPosition.y = posDist(m_twister);
+		m_previousShipPosition = m_shipPosition;
 	}
 
 	if (m_leftKeyDown)
@@ -326,6 +351,10 @@ void Game::update(float dt)
 		{
 			m_shipVelocity *= maxSpeed / speed;
 		}
+
+		// exhaust behind the ship
+		const vec2 back = vec2(sin(m_shipRotation), -cos(m_shipRotation));
+		m_particles.emitCone(m_shipPosition + back * m_shipRadius * 0.5f, m_shipVelocity, m_shipRotation + 3.1415926f, 0.3f, 2, 0.0005f, 300.0f, vec3(1.0f, 0.6f, 0.1f));
 	}
 
 	// update ship position
@@ -338,127 +367,80 @@ void Game::update(float dt)
 	m_missleReloadTime -= dt;
 	if (m_fireDown && m_missleReloadTime <= 0.0f)
 	{
-		// 0.2s reload time
-		m_missleReloadTime = 200.0f;
 		// fire missle
-		MissleData d;
+		MissleData d{};
 		d.position = m_shipPosition;
+		d.previousPosition = m_shipPosition;
 		d.velocity = vec2(-sin(m_shipRotation), cos(m_shipRotation)) * 0.00175f + m_shipVelocity;
 		d.rotation = m_shipRotation;
-		// 1 s lifetime
-		d.lifetime = 1000.0f;
-		m_missles.push_back(d);
+		d.lifetime = s_missleLifetime;
+		// the pool is sized for the fire rate, a full pool only delays the shot
+		if (m_missles.fire(d))
+			m_missleReloadTime = s_missleReloadTime;
 	}
 
 	// update missles
-	for (auto& m : m_missles)
-	{
-		m.lifetime -= dt;
-		m.position += m.velocity * dt;
-		clipObject(m.position, m.velocity, m_missleRadius);
-	}
+	m_missles.forEach([this, dt](size_t, MissleData& m)
+		{
+			m.lifetime -= dt;
+			m.previousPosition = m.position;
+			m.position += m.velocity * dt;
+			clipObject(m.position, m.velocity, m_missleRadius);
+		});
+
+	// remove expired missles
+	m_missles.expire();
 
-	// remove dead missles
-	while (!m_missles.empty() && m_missles.front().lifetime < 0.0f)
-		m_missles.pop_front();
+	// broadphase for the collision tests
+	if (m_useCollisionGrid)
+		buildCollisionGrid();
 
-	// handle missle/asteroid collission
-	auto newEnd = std::remove_if(m_missles.begin(), m_missles.end(), [this](const MissleData& m)
+	// handle missle/asteroid collission: query all missles in parallel (against the asteroids of the tick start)
+	m_threadPool->parallelFor(m_missleHits.size(), s_missleChunkSize, [this, dt](size_t, size_t first, size_t last)
 		{
-			const float asteroidSlow = 0.75f;
-			// test big asteroids
-			for (auto& a : m_bigAsteroids)
+			for (size_t slot = first; slot < last; ++slot)
 			{
-				// big ones (simple bounding sphere test)
-				if (a.alive && distance(a.position, m.position) < m_missleRadius + m_bigAsteroidRadius)
-				{
-					// collision
-					a.alive = false;
-					// spawn smaller asteroids
-					AsteroidData newAsteroid;
-					newAsteroid.position = a.position;
-					newAsteroid.velocity = a.velocity * asteroidSlow + generateAsteroidVelocity();
-					m_midAsteroids.push_back(newAsteroid);
-					newAsteroid.velocity = a.velocity * asteroidSlow + generateAsteroidVelocity();
-					m_midAsteroids.push_back(newAsteroid);
-					m_score += 20;
-					return true;
-				}
+				size_t index;
+				m_missleHits[slot] = m_missles[slot].alive &&
+					findMissleHit(m_missles[slot].position, m_missles[slot].previousPosition, m_missles[slot].velocity, dt, index) ? index : s_noHit;
 			}
+		});
 
-			// test mid asteroids
-			for (auto& a : m_midAsteroids)
+	// apply the hits in fire order (same result as testing the missles one after another)
+	const size_t asteroidCount = m_asteroids.count();
+	m_missles.forEach([&](size_t slot, MissleData& m)
+		{
+			size_t index = m_missleHits[slot];
+			// the first hit is still valid as long as it is alive and no smaller asteroids were spawned
+			if (m_asteroids.count() != asteroidCount || (index != s_noHit && !m_asteroids.alive[index]))
 			{
-				// mid ones
-				if (a.alive && distance(a.position, m.position) < m_missleRadius + m_midAsteroidRadius)
-				{
-					// collision
-					a.alive = false;
-					// spawn smaller asteroids
-					AsteroidData newAsteroid;
-					newAsteroid.position = a.position;
-					newAsteroid.velocity = a.velocity * asteroidSlow + generateAsteroidVelocity();
-					m_smallAsteroids.push_back(newAsteroid);
-					newAsteroid.velocity = a.velocity * asteroidSlow + generateAsteroidVelocity();
-					m_smallAsteroids.push_back(newAsteroid);
-					m_score += 50;
-					return true;
-				}
+				if (!findMissleHit(m.position, m.previousPosition, m.velocity, dt, index))
+					index = s_noHit;
 			}
 
-			// test small ones
-			for (auto& a : m_smallAsteroids)
-			{
-				// small ones
-				if (a.alive && distance(a.position, m.position) < m_missleRadius + m_smallAsteroidRadius)
-				{
-					// collision
-					a.alive = false;
-					m_score += 100;
-					return true;
-				}
-			}
+			if (index == s_noHit)
+				return;
 
-			return false;
+			m.alive = false;
+			destroyAsteroid(index);
 		});
-	m_missles.erase(newEnd, m_missles.end());
-
-	// erase dead asteroids
-	eraseDeadAsteroids(m_bigAsteroids);
-	eraseDeadAsteroids(m_midAsteroids);
-	eraseDeadAsteroids(m_smallAsteroids);
+	m_missles.expire();
 
-	// test for asteroid/ship collission
-	const float fairShipRadius = m_shipRadius * 0.5f;
-	for (const auto& a : m_bigAsteroids)
-	{
-		if (distance(a.position, m_shipPosition) < m_bigAsteroidRadius + fairShipRadius)
-		{
-			m_gameOver = true;
-			return;
-		}
-	}
+	// test for asteroid/ship collission (before the dead asteroids are erased to keep the grid valid)
+	const bool shipHit = testShipHit(dt);
 
-	for (const auto& a : m_midAsteroids)
-	{
-		if (distance(a.position, m_shipPosition) < m_midAsteroidRadius + fairShipRadius)
-		{
-			m_gameOver = true;
-			return;
-		}
-	}
+	// erase dead asteroids
+	m_asteroids.eraseDead();
 
-	for (const auto& a : m_smallAsteroids)
+	if (shipHit)
 	{
-		if (distance(a.position, m_shipPosition) < m_smallAsteroidRadius + fairShipRadius)
-		{
-			m_gameOver = true;
-			return;
-		}
+		m_particles.emitBurst(m_shipPosition, m_shipVelocity, 200, 0.0006f, 1500.0f, vec3(1.0f, 0.8f, 0.4f));
+		m_gameOver = true;
+		return;
 	}
 
 	// level clear?
-	if (m_bigAsteroids.empty() && m_midAsteroids.empty() && m_smallAsteroids.empty())
+	if (m_asteroids.empty())
 	{
 		nextLevel();
 	}
@@ -473,51 +455,52 @@ void Game::nextLevel()
 	m_rightKeyDown = false;
 	m_upKeyDown = false;
 	m_shipRotation = 0.0f;
+	m_previousShipPosition = m_shipPosition;
+	m_previousShipRotation = m_shipRotation;
 	m_warpRequest = false;
 
 	m_missles.clear();
 	m_gameOver = false;
 
 	// reset asteroid status
-	m_bigAsteroids.clear();
-	m_midAsteroids.clear();
-	m_smallAsteroids.clear();
+	m_asteroids.clear();
 
 	// generate random asteroids
 	auto asteroidSideDist = std::uniform_int_distribution<int>(0, 3);
 	auto asteroidPositionDist = std::uniform_real_distribution<float>(-1.0f, 1.0f);
 	auto rotationDist = std::uniform_real_distribution<float>(0.0f, 6.3f);
 
-	const int numAsteroids = 4 + 2 * m_currentLevel++;
+	const int numAsteroids = m_asteroidsPerLevel > 0 ? m_asteroidsPerLevel : 4 + 2 * m_currentLevel;
+	++m_currentLevel;
 	for (int i = 0; i < numAsteroids; ++i)
 	{
-		AsteroidData d;
+		vec2 position;
 		// start position
 		const float pos = asteroidPositionDist(m_twister);
 		switch (asteroidSideDist(m_twister))
 		{
 		case 0:
-			d.position.x = pos;
-			d.position.y = -1.0f;
+			position.x = pos;
+			position.y = -1.0f;
 			break;
 		case 1:
-			d.position.x = pos;
-			d.position.y = 1.0f;
+			position.x = pos;
+			position.y = 1.0f;
 			break;
 		case 2:
-			d.position.y = pos;
-			d.position.x = -1.0f;
+			position.y = pos;
+			position.x = -1.0f;
 			break;
 		case 3:
-			d.position.y = pos;
-			d.position.x = 1.0f;
+			position.y = pos;
+			position.x = 1.0f;
 			break;
 		}
 		// start velocity and rotation
-		d.rotation = rotationDist(m_twister);
-		d.velocity = generateAsteroidVelocity();
+		const float rotation = rotationDist(m_twister);
+		const vec2 velocity = generateAsteroidVelocity();
 
-		m_bigAsteroids.push_back(d);
+		m_asteroids.add(position, velocity, rotation, AsteroidStore::BIG);
 	}
 }
 
@@ -541,11 +524,179 @@ glm::vec2 Game::generateAsteroidVelocity()
 	return vel;
 }
 
-void Game::eraseDeadAsteroids(std::vector<AsteroidData>& vec)
+void Game::buildCollisionGrid()
+{
+	m_collisionGrid.build(m_asteroids.positionX.data(), m_asteroids.positionY.data(), m_asteroids.count(), *m_threadPool);
+}
+
+/// \brief swept circle test. Both objects moved with constant velocity during the step
+/// \param offset position of object a relative to object b after the step
+/// \param displacement movement of object a relative to object b during the step
+/// \param radius sum of both radii
+/// \return true if the objects were closer than radius at any time of the step
+static bool sweptCircleHit(const vec2& offset, const vec2& displacement, float radius)
+{
+	// closest point of the segment [offset - displacement, offset] to the origin
+	const vec2 start = offset - displacement;
+	const float len2 = dot(displacement, displacement);
+	const float t = len2 > 0.0f ? clamp(-dot(start, displacement) / len2, 0.0f, 1.0f) : 1.0f;
+	const vec2 closest = start + t * displacement;
+	return dot(closest, closest) < radius * radius;
+}
+
+/// \brief undoes a screen wrap of the last step (see Game::clipObject). A wrap mirrors the position,
+/// a regular step moves far less than the screen size
+static vec2 unwrapPosition(const vec2& position, const vec2& previous)
+{
+	return vec2(abs(position.x - previous.x) > 1.0f ? -position.x : position.x,
+		abs(position.y - previous.y) > 1.0f ? -position.y : position.y);
+}
+
+/// \brief swept circle test that respects screen wraps. The wrap happens at the end of the step, so the
+/// paths before the wraps are swept and the wrapped positions are only tested at the end of the step
+/// \param displacement movement of object a relative to object b during the step
+/// \param radius sum of both radii
+static bool sweptWrappedHit(const vec2& positionA, const vec2& previousA, const vec2& positionB, const vec2& previousB,
+	const vec2& displacement, float radius)
+{
+	const vec2 a = unwrapPosition(positionA, previousA);
+	const vec2 b = unwrapPosition(positionB, previousB);
+	if (sweptCircleHit(a - b, displacement, radius))
+		return true;
+
+	if (a == positionA && b == positionB)
+		return false;
+
+	const vec2 offset = positionA - positionB;
+	return dot(offset, offset) < radius * radius;
+}
+
+/// \brief grid query that also visits the objects that a screen wrap moved to the other side of the screen.
+/// The mirrored positions are queried on the axes where the query square reaches the screen border
+template<class TVisitor>
+static void queryWrapped(const CollisionGrid& grid, const vec2& position, float radius, TVisitor&& visit)
+{
+	const bool mirrorX = abs(position.x) > 1.0f - radius;
+	const bool mirrorY = abs(position.y) > 1.0f - radius;
+	grid.query(position, radius, visit);
+	if (mirrorX)
+		grid.query(vec2(-position.x, position.y), radius, visit);
+	if (mirrorY)
+		grid.query(vec2(position.x, -position.y), radius, visit);
+	if (mirrorX && mirrorY)
+		grid.query(-position, radius, visit);
+}
+
+bool Game::findMissleHit(const vec2& position, const vec2& previousPosition, const vec2& velocity, float dt, size_t& index) const
+{
+	const auto& asteroids = m_asteroids;
+	auto collides = [&](size_t i)
+	{
+		return asteroids.alive[i] && sweptWrappedHit(position, previousPosition, asteroids.getPosition(i), asteroids.getPreviousPosition(i),
+			(velocity - asteroids.getVelocity(i)) * dt, m_missleRadius + AsteroidStore::radius[asteroids.size[i]]);
+	};
+
+	if (!m_useCollisionGrid)
+	{
+		// brute force: first hit in the order big, mid, small
+		for (int size = 0; size < AsteroidStore::NUM_SIZES; ++size)
+		{
+			for (size_t i = 0; i < asteroids.count(); ++i)
+			{
+				if (asteroids.size[i] == size && collides(i))
+				{
+					index = i;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// the smallest (size, index) key is the first hit of the brute force order.
+	// The query radius covers the largest distance that both objects can travel during the step
+	const float queryRadius = m_missleRadius + AsteroidStore::radius[AsteroidStore::BIG] +
+		(length(velocity) + AsteroidStore::maxSpeed[AsteroidStore::SMALL]) * dt;
+	uint64_t hit = UINT64_MAX;
+	queryWrapped(m_collisionGrid, position, queryRadius, [&](uint32_t i)
+		{
+			const uint64_t key = (uint64_t(asteroids.size[i]) << 32) | i;
+			if (key < hit && collides(i))
+				hit = key;
+		});
+
+	if (hit == UINT64_MAX)
+		return false;
+
+	index = size_t(hit & 0xffffffffu);
+	return true;
+}
+
+bool Game::testShipHit(float dt) const
 {
-	auto end = std::remove_if(vec.begin(), vec.end(), [](const AsteroidData& a)
+	const auto& asteroids = m_asteroids;
+	const float fairShipRadius = m_shipRadius * 0.5f;
+	auto collides = [&](size_t i)
+	{
+		return asteroids.alive[i] && sweptWrappedHit(m_shipPosition, m_previousShipPosition, asteroids.getPosition(i), asteroids.getPreviousPosition(i),
+			(m_shipVelocity - asteroids.getVelocity(i)) * dt, AsteroidStore::radius[asteroids.size[i]] + fairShipRadius);
+	};
+
+	if (!m_useCollisionGrid)
+	{
+		for (size_t i = 0; i < asteroids.count(); ++i)
 		{
-			return !a.alive;
+			if (collides(i))
+				return true;
+		}
+		return false;
+	}
+
+	const float queryRadius = AsteroidStore::radius[AsteroidStore::BIG] + fairShipRadius +
+		(length(m_shipVelocity) + AsteroidStore::maxSpeed[AsteroidStore::SMALL]) * dt;
+	bool hit = false;
+	queryWrapped(m_collisionGrid, m_shipPosition, queryRadius, [&](uint32_t i)
+		{
+			hit = hit || collides(i);
 		});
-	vec.erase(end, vec.end());
+	return hit;
+}
+
+void Game::destroyAsteroid(size_t index)
+{
+	const float asteroidSlow = 0.75f;
+	m_asteroids.alive[index] = 0;
+
+	const auto size = AsteroidStore::Size(m_asteroids.size[index]);
+
+	// debris (more for bigger asteroids)
+	static constexpr size_t debrisCount[] = { 48, 32, 24 };
+	m_particles.emitBurst(m_asteroids.getPosition(index), m_asteroids.getVelocity(index), debrisCount[size], 0.0004f, 800.0f, vec3(0.8f, 0.7f, 0.6f));
+
+	switch (size)
+	{
+	case AsteroidStore::BIG:
+		m_score += 20;
+		break;
+	case AsteroidStore::MID:
+		m_score += 50;
+		break;
+	default:
+		m_score += 100;
+		// small ones do not split
+		return;
+	}
+
+	// spawn two smaller asteroids
+	const vec2 position = m_asteroids.getPosition(index);
+	const vec2 velocity = m_asteroids.getVelocity(index);
+	const float rotation = m_asteroids.rotation[index];
+	for (int i = 0; i < 2; ++i)
+	{
+		const vec2 newVelocity = velocity * asteroidSlow + generateAsteroidVelocity();
+		const size_t newIndex = m_asteroids.add(position, newVelocity, rotation, AsteroidStore::Size(size + 1));
+		// later missles of this tick can hit the new asteroids
+		if (m_useCollisionGrid)
+			m_collisionGrid.insert(uint32_t(newIndex));
+	}
 }
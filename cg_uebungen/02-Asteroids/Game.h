@@ -3,35 +3,37 @@
 #include "Vertex.h"
 #include <vector>
 #include "Pipeline.h"
-#include "../framework/Window.h"
-#include <deque>
+#include "SpriteCache.h"
+#include "CollisionGrid.h"
+#include "AsteroidStore.h"
+#include "MisslePool.h"
+#include "GameSnapshot.h"
+#include "MeshLod.h"
+#include "ParticleSystem.h"
+#include "../framework/ThreadPool.h"
+#include "InputSource.h"
 #include <random>
+#include <memory>
+#include <array>
+#include <cstdint>
 
 class Game
 {
-	struct AsteroidData
-	{
-		glm::vec2 position;
-		glm::vec2 velocity;
-		float rotation;
-		bool alive = true;
-	};
-	struct MissleData
-	{
-		glm::vec2 position;
-		glm::vec2 velocity;
-		float rotation;
-		float lifetime;
-	};
 public:
-	Game(Window& window);
+	/// \brief time step of update() in milliseconds (60 Hz, the collision tests are continuous)
+	static constexpr float TICK_TIME = 1000.0f / 60.0f;
+
+	/// \param input controls that are polled once per update
+	/// \param seed seed of the random number generator (same seed and input give the same game)
+	Game(InputSource& input, uint32_t seed);
 	
 	/// \brief draw code for the game 
 	/// \param gfx graphics pipeline
-	void draw(Pipeline& gfx) const;
+	/// \param alpha interpolation factor between the previous (0) and the current (1) update
+	void draw(Pipeline& gfx, float alpha = 1.0f) const;
 
 	/// \brief game logic (collission, updates for ship, missles and asteroids)
-	/// \param dt time delta in milliseconds
+	/// \param dt time delta in milliseconds (should be TICK_TIME)
 	void update(float dt);
 
 	/// \brief returns the current level
@@ -39,7 +41,47 @@ public:
 
 	/// \brief returns the game score
 	int getScore() const { return m_score; }
+
+	/// \brief returns true if the ship was destroyed (InputState::reset restarts the game)
+	bool isGameOver() const { return m_gameOver; }
+
+	/// \brief returns the number of active asteroids
+	size_t getAsteroidCount() const { return m_asteroids.count(); }
+
+	/// \brief overrides the number of big asteroids that are spawned for each level
+	/// \param count number of asteroids (0 uses the default of 4 + 2 * level). Applies to the next level
+	void setAsteroidsPerLevel(int count) { m_asteroidsPerLevel = count; }
+
+	/// \brief switches between the uniform grid broadphase and brute force collision tests (same results)
+	/// \param enable true to use the grid
+	void setCollisionGrid(bool enable) { m_useCollisionGrid = enable; }
+
+	/// \brief copies the complete game state into the snapshot (memcpy of a header and the asteroid arrays)
+	void saveSnapshot(GameSnapshot& snapshot) const;
+
+	/// \brief restores a state of saveSnapshot()
+	void loadSnapshot(const GameSnapshot& snapshot);
+
+	/// \return size of a snapshot with the given number of asteroids in bytes (to preallocate snapshots)
+	static size_t getSnapshotSize(size_t asteroidCount);
+
+	/// \brief sets the number of threads for the asteroid updates and collision tests.
+	/// The game state does not depend on the thread count
+	/// \param count number of threads (0 = hardware concurrency, 1 = no worker threads)
+	void setThreadCount(size_t count);
+
+	/// \brief sets the maximum outline error of reduced asteroid meshes
+	/// \param pixels tolerance in pixels (0 always draws the original meshes)
+	void setLodTolerance(float pixels) { m_lodTolerance = pixels; }
+
+	/// \brief draws asteroids as pre-rasterized sprites instead of triangles
+	/// \param rotations number of cached rotations per asteroid mesh (0 disables the cache)
+	/// \param maxBytes memory budget of the sprite atlas
+	void setSpriteCache(size_t rotations, size_t maxBytes = 16 * 1024 * 1024);
 private:
+	/// \brief fixed size part of a snapshot
+	struct SnapshotHeader;
+
 	/// \brief advance to next level
 	void nextLevel();
 
@@ -58,37 +100,80 @@ private:
 	/// \brief generates random velocity for a new asteroid
 	glm::vec2 generateAsteroidVelocity();
 
-	/// \brief erases all asteroids with alive = false status
-	void eraseDeadAsteroids(std::vector<AsteroidData>& vec);
+	/// \brief inserts all asteroids into the collision grid
+	void buildCollisionGrid();
+
+	/// \brief finds the asteroid that is hit by a missle during the last step (first alive one in the order big, mid, small)
+	/// \param position missle position after the step
+	/// \param previousPosition missle position before the step (to detect a screen wrap)
+	/// \param velocity missle velocity
+	/// \param dt time step in milliseconds
+	/// \param index index of the hit asteroid
+	/// \return true if an asteroid was hit
+	bool findMissleHit(const glm::vec2& position, const glm::vec2& previousPosition, const glm::vec2& velocity, float dt, size_t& index) const;
+
+	/// \return true if an alive asteroid collided with the ship during the last step
+	/// \param dt time step in milliseconds
+	bool testShipHit(float dt) const;
+
+	/// \brief kills an asteroid, spawns the smaller ones and adds the score
+	void destroyAsteroid(size_t index);
+
+	/// \brief draws all asteroids of a size with the sprite cache if possible or the mesh otherwise
+	void drawAsteroids(Pipeline& gfx, AsteroidStore::Size size, float alpha) const;
 private:
+	// controls
+	InputSource& m_input;
+
 	// mersenne twister (random number generator)
 	std::mt19937 m_twister;
 
 	// mesh data
-	std::vector<Vertex> m_bigAsteroidMesh;
-	std::vector<Vertex> m_midAsteroidMesh;
-	std::vector<Vertex> m_smallAsteroidMesh;
+	// detail levels of the asteroids (the first one is the original mesh)
+	std::array<std::vector<MeshLod>, AsteroidStore::NUM_SIZES> m_asteroidMeshes;
+	float m_lodTolerance = 1.0f;
 	std::vector<Vertex> m_shipMesh;
 	std::vector<Vertex> m_shipFireMesh;
 	std::vector<Vertex> m_missleMesh;
+
+	// pre-rasterized asteroids (the cache fills lazily while drawing)
+	mutable std::unique_ptr<SpriteCache> m_spriteCache;
+	std::array<int, AsteroidStore::NUM_SIZES> m_asteroidSprites = {};
 	
-	// entity scalings
-	const float m_bigAsteroidRadius = 0.1f;
-	const float m_midAsteroidRadius = 0.06f;
-	const float m_smallAsteroidRadius = 0.035f;
+	// entity scalings (asteroid radii are in AsteroidStore::radius)
 	const float m_shipRadius = 0.05f;
 	const float m_missleRadius = 0.01f;
 
 	// active asteroids
-	std::vector<AsteroidData> m_bigAsteroids;
-	std::vector<AsteroidData> m_midAsteroids;
-	std::vector<AsteroidData> m_smallAsteroids;
+	AsteroidStore m_asteroids;
+
+	// missle timings in milliseconds
+	static constexpr float s_missleReloadTime = 200.0f;
+	static constexpr float s_missleLifetime = 1000.0f;
+
+	// active missles (the oldest one may still be alive when the next one is fired)
+	MisslePool<size_t(s_missleLifetime / s_missleReloadTime) + 2> m_missles;
+
+	// worker threads (parallel loops split the asteroids into chunks of at least this size)
+	std::unique_ptr<ThreadPool> m_threadPool;
+	static constexpr size_t s_asteroidChunkSize = 4096;
+	static constexpr size_t s_missleChunkSize = 16;
+
+	// hit asteroid of every missle slot (s_noHit if none)
+	std::array<size_t, decltype(m_missles)::CAPACITY> m_missleHits;
+	static constexpr size_t s_noHit = SIZE_MAX;
+
+	// explosion and thrust effects (not part of the game state)
+	ParticleSystem m_particles;
+	static constexpr size_t s_maxParticles = 1 << 17;
 
-	// active missles
-	std::deque<MissleData> m_missles;
+	// broadphase (cells are larger than the biggest collision distance)
+	bool m_useCollisionGrid = true;
+	CollisionGrid m_collisionGrid = CollisionGrid(0.125f, 1.2f);
 
 	// level and score
 	int m_currentLevel = 0;
+	int m_asteroidsPerLevel = 0;
 	int m_score = 0;
 	bool m_gameOver = false;
 	float m_totalTime = 0.0f;
@@ -98,6 +183,8 @@ private:
 	glm::vec2 m_shipPosition;
 	glm::vec2 m_shipVelocity;
 	float m_shipRotation = 0.0f;
+	glm::vec2 m_previousShipPosition;
+	float m_previousShipRotation = 0.0f;
 
 	// key data
 	bool m_leftKeyDown = false;
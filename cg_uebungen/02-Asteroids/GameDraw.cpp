@@ -0,0 +1,86 @@
+#include "Game.h"
+#include <algorithm>
+
+using namespace glm;
+
+/// \brief interpolates between two updates. Jumps (screen wrap, warp) are not interpolated
+static float interpolatePosition(float previous, float current, float alpha)
+{
+	if (abs(current - previous) > 1.0f)
+		return current;
+	return mix(previous, current, alpha);
+}
+
+static vec2 interpolatePosition(const vec2& previous, const vec2& current, float alpha)
+{
+	return vec2(
+		interpolatePosition(previous.x, current.x, alpha),
+		interpolatePosition(previous.y, current.y, alpha));
+}
+
+void Game::draw(Pipeline& gfx, float alpha) const
+{
+	// draw missles
+	gfx.setVertexScale(m_missleRadius);
+	m_missles.forEach([&](size_t, const MissleData& m)
+		{
+			gfx.setVertexRotation(m.rotation);
+			gfx.setVertexTranslation(interpolatePosition(m.previousPosition, m.position, alpha));
+			gfx.drawTriangleList(m_missleMesh);
+		});
+
+	// draw particles (move them back to the interpolated time)
+	m_particles.prepareDraw((alpha - 1.0f) * TICK_TIME);
+	// about one pixel per 400 pixels of render height
+	const int particleSize = std::max(1, gfx.getRenderHeight() / 400);
+	gfx.drawPoints(m_particles.getDrawX(), m_particles.getDrawY(), m_particles.getDrawColors(), m_particles.count(), particleSize);
+
+	// draw asteroids
+	drawAsteroids(gfx, AsteroidStore::BIG, alpha);
+	drawAsteroids(gfx, AsteroidStore::MID, alpha);
+	drawAsteroids(gfx, AsteroidStore::SMALL, alpha);
+
+	// draw ship
+	gfx.setVertexScale(m_shipRadius);
+	gfx.setVertexRotation(mix(m_previousShipRotation, m_shipRotation, alpha));
+	gfx.setVertexTranslation(interpolatePosition(m_previousShipPosition, m_shipPosition, alpha));
+
+	//Draw fire
+	if (m_upKeyDown && !m_gameOver)
+	{
+		gfx.setFragmentScale(0.5f + 0.5f * sin(m_totalTime * 0.04f));
+		gfx.drawTriangleList(m_shipFireMesh);
+		gfx.setFragmentScale(1.0f);
+	}
+
+	gfx.drawTriangleList(m_shipMesh);
+}
+
+void Game::drawAsteroids(Pipeline& gfx, AsteroidStore::Size size, float alpha) const
+{
+	gfx.setVertexScale(AsteroidStore::radius[size]);
+
+	// all asteroids of a size have the same screen size (NDC [-1, 1] covers the render target)
+	const float pixelsPerUnit = AsteroidStore::radius[size] * 0.5f * float(std::min(gfx.getRenderWidth(), gfx.getRenderHeight()));
+	const auto& mesh = m_asteroidMeshes[size][selectLod(m_asteroidMeshes[size], pixelsPerUnit, m_lodTolerance)].triangles;
+	for (size_t i = 0; i < m_asteroids.count(); ++i)
+	{
+		if (m_asteroids.size[i] != size)
+			continue;
+
+		const vec2 position = interpolatePosition(m_asteroids.getPreviousPosition(i), m_asteroids.getPosition(i), alpha);
+		const float rotation = mix(m_asteroids.previousRotation[i], m_asteroids.rotation[i], alpha);
+
+		Sprite s;
+		if (m_spriteCache && m_spriteCache->get(m_asteroidSprites[size], rotation, gfx.getRenderWidth(), gfx.getRenderHeight(), s))
+		{
+			gfx.drawSprite(s, position);
+			continue;
+		}
+
+		// fallback if the cache is disabled or full
+		gfx.setVertexRotation(rotation);
+		gfx.setVertexTranslation(position);
+		gfx.drawTriangleList(mesh);
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/// \brief serialized game state (see Game::saveSnapshot). The storage is kept, so capturing
+/// a state that is not larger than a previous one does not allocate
+class GameSnapshot
+{
+public:
+	/// \brief sets the size of the snapshot
+	/// \return pointer to the snapshot data
+	uint8_t* resize(size_t size)
+	{
+		if (size > m_data.size())
+			m_data.resize(size);
+		m_size = size;
+		return m_data.data();
+	}
+
+	/// \brief preallocates the storage
+	void reserve(size_t size)
+	{
+		if (size > m_data.size())
+			m_data.resize(size);
+	}
+
+	const uint8_t* data() const { return m_data.data(); }
+
+	/// \return size of the snapshot in bytes
+	size_t getSize() const { return m_size; }
+private:
+	std::vector<uint8_t> m_data;
+	size_t m_size = 0;
+};
+
+/// \brief preallocated ring of the last snapshots (for rewinding). The oldest snapshot is overwritten if the ring is full
+class SnapshotRing
+{
+public:
+	/// \param capacity number of snapshots
+	/// \param reserveBytes preallocated storage per snapshot
+	explicit SnapshotRing(size_t capacity, size_t reserveBytes = 0)
+		:
+		m_snapshots(capacity)
+	{
+		for (auto& s : m_snapshots)
+			s.reserve(reserveBytes);
+	}
+
+	/// \return snapshot that has to be overwritten with the newest state
+	GameSnapshot& push()
+	{
+		if (m_count == m_snapshots.size())
+			m_first = (m_first + 1) % m_snapshots.size();
+		else
+			++m_count;
+		return m_snapshots[(m_first + m_count - 1) % m_snapshots.size()];
+	}
+
+	/// \brief removes the newest snapshot
+	/// \return the removed snapshot (valid until the next push()) or nullptr if the ring is empty
+	const GameSnapshot* pop()
+	{
+		if (m_count == 0)
+			return nullptr;
+		return &m_snapshots[(m_first + --m_count) % m_snapshots.size()];
+	}
+
+	size_t getCount() const { return m_count; }
+	bool empty() const { return m_count == 0; }
+	void clear() { m_count = 0; }
+private:
+	std::vector<GameSnapshot> m_snapshots;
+	// oldest snapshot
+	size_t m_first = 0;
+	size_t m_count = 0;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+/// \brief game controls of a single update step
+struct InputState
+{
+	// held keys
+	bool left = false;
+	bool right = false;
+	bool thrust = false;
+	bool fire = false;
+
+	// edges (set once per key press)
+	bool warp = false;
+	bool reset = false;
+};
+
+/// \brief provides the game controls (keyboard, scripted input, replays...)
+class InputSource
+{
+public:
+	virtual ~InputSource() = default;
+
+	/// \brief returns the current controls and consumes the edge flags
+	virtual InputState poll() = 0;
+};
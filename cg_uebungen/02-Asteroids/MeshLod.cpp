@@ -0,0 +1,156 @@
+#include "MeshLod.h"
+#include <random>
+#include <limits>
+
+using namespace glm;
+
+/// \return twice the signed area of the triangle (positive if counter clockwise)
+static float cross2(const vec2& a, const vec2& b, const vec2& c)
+{
+	return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+/// \return distance between the point and the segment [a, b]
+static float segmentDistance(const vec2& p, const vec2& a, const vec2& b)
+{
+	const vec2 ab = b - a;
+	const float len2 = dot(ab, ab);
+	const float t = len2 > 0.0f ? clamp(dot(p - a, ab) / len2, 0.0f, 1.0f) : 0.0f;
+	return distance(p, a + t * ab);
+}
+
+/// \return maximum distance of the original vertices to the reduced outline
+static float outlineError(const std::vector<vec2>& original, const std::vector<vec2>& reduced)
+{
+	float error = 0.0f;
+	for (const auto& p : original)
+	{
+		float d = std::numeric_limits<float>::max();
+		for (size_t i = 0; i < reduced.size(); ++i)
+			d = std::min(d, segmentDistance(p, reduced[i], reduced[(i + 1) % reduced.size()]));
+		error = std::max(error, d);
+	}
+	return error;
+}
+
+/// \brief triangulates a simple polygon with ear clipping
+/// \param polygon vertices in order
+/// \param triangles output indices
+/// \return false if the polygon could not be triangulated (self intersections)
+static bool earClip(const std::vector<vec2>& polygon, std::vector<size_t>& triangles)
+{
+	// orientation of the polygon
+	float area = 0.0f;
+	for (size_t i = 0; i < polygon.size(); ++i)
+		area += cross2(vec2(0.0f), polygon[i], polygon[(i + 1) % polygon.size()]);
+	const float orientation = area >= 0.0f ? 1.0f : -1.0f;
+
+	std::vector<size_t> remaining(polygon.size());
+	for (size_t i = 0; i < remaining.size(); ++i)
+		remaining[i] = i;
+
+	while (remaining.size() > 3)
+	{
+		bool found = false;
+		for (size_t i = 0; i < remaining.size() && !found; ++i)
+		{
+			const size_t prev = remaining[(i + remaining.size() - 1) % remaining.size()];
+			const size_t cur = remaining[i];
+			const size_t next = remaining[(i + 1) % remaining.size()];
+			const vec2& a = polygon[prev];
+			const vec2& b = polygon[cur];
+			const vec2& c = polygon[next];
+
+			// reflex or degenerated corner?
+			if (cross2(a, b, c) * orientation <= 0.0f)
+				continue;
+
+			// no other vertex inside the ear
+			bool empty = true;
+			for (auto j : remaining)
+			{
+				if (j == prev || j == cur || j == next)
+					continue;
+				const vec2& p = polygon[j];
+				if (cross2(a, b, p) * orientation >= 0.0f &&
+					cross2(b, c, p) * orientation >= 0.0f &&
+					cross2(c, a, p) * orientation >= 0.0f)
+				{
+					empty = false;
+					break;
+				}
+			}
+			if (!empty)
+				continue;
+
+			triangles.push_back(prev);
+			triangles.push_back(cur);
+			triangles.push_back(next);
+			remaining.erase(remaining.begin() + i);
+			found = true;
+		}
+
+		if (!found)
+			return false;
+	}
+
+	triangles.insert(triangles.end(), remaining.begin(), remaining.end());
+	return true;
+}
+
+std::vector<MeshLod> makeOutlineLods(const std::vector<vec2>& outline, unsigned colorSeed)
+{
+	std::vector<MeshLod> lods;
+	std::vector<vec2> reduced = outline;
+
+	// every level has about 2/3 of the vertices of the previous one (down to a triangle)
+	size_t target = outline.size();
+	while (target > 3)
+	{
+		target = std::max<size_t>(3, target * 2 / 3);
+
+		// Visvalingam-Whyatt: remove the vertex that spans the smallest triangle with its neighbors
+		while (reduced.size() > target)
+		{
+			size_t smallest = 0;
+			float smallestArea = std::numeric_limits<float>::max();
+			for (size_t i = 0; i < reduced.size(); ++i)
+			{
+				const float area = abs(cross2(reduced[(i + reduced.size() - 1) % reduced.size()], reduced[i], reduced[(i + 1) % reduced.size()]));
+				if (area < smallestArea)
+				{
+					smallestArea = area;
+					smallest = i;
+				}
+			}
+			reduced.erase(reduced.begin() + smallest);
+		}
+
+		std::vector<size_t> indices;
+		if (!earClip(reduced, indices))
+			break;
+
+		MeshLod lod;
+		lod.error = outlineError(outline, reduced);
+
+		// random gray color (same as the original meshes)
+		std::mt19937 twister(colorSeed + unsigned(reduced.size()));
+		auto dist = std::uniform_real_distribution<float>(0.5f, 0.8f);
+		for (auto i : indices)
+			lod.triangles.push_back(Vertex(reduced[i], vec3(dist(twister))));
+
+		lods.push_back(std::move(lod));
+	}
+
+	return lods;
+}
+
+size_t selectLod(const std::vector<MeshLod>& lods, float pixelsPerUnit, float tolerance)
+{
+	for (size_t i = lods.size(); i > 1; --i)
+	{
+		if (lods[i - 1].error * pixelsPerUnit <= tolerance)
+			return i - 1;
+	}
+	return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Vertex.h"
+#include <vector>
+
+/// \brief triangle list of a detail level
+struct MeshLod
+{
+	std::vector<Vertex> triangles;
+	// maximum distance between the original outline and the outline of this level (mesh units)
+	float error = 0.0f;
+};
+
+/// \brief derives reduced detail levels of a polygon mesh.
+/// The outline is simplified with Visvalingam-Whyatt (removes the vertex with the smallest triangle area)
+/// and every level is triangulated with ear clipping.
+/// \param outline polygon vertices in order (convex or concave, no self intersections)
+/// \param colorSeed seed of the random vertex colors (gray)
+/// \return levels ordered from the most to the least detailed (without the original mesh)
+std::vector<MeshLod> makeOutlineLods(const std::vector<glm::vec2>& outline, unsigned colorSeed);
+
+/// \brief selects the least detailed level whose error is below the tolerance
+/// \param lods levels ordered from the most to the least detailed (lods[0] should have an error of 0)
+/// \param pixelsPerUnit size of one mesh unit on the screen in pixels
+/// \param tolerance maximum error in pixels
+/// \return index into lods
+size_t selectLod(const std::vector<MeshLod>& lods, float pixelsPerUnit, float tolerance);
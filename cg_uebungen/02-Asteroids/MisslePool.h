@@ -0,0 +1,96 @@
+#pragma once
+#include "../framework/glmmath.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct MissleData
+{
+	glm::vec2 position;
+	glm::vec2 previousPosition;
+	glm::vec2 velocity;
+	float rotation;
+	float lifetime;
+	bool alive;
+	// explicit padding: the pool is copied into snapshots, which are compared bytewise
+	uint8_t padding[3];
+};
+static_assert(sizeof(MissleData) == 9 * sizeof(float), "MissleData must not contain implicit padding");
+
+/// \brief fixed-capacity ring of missles in fire order (no heap allocations).
+/// All missles have the same lifetime, so they expire at the front of the ring. Missles that hit
+/// something are only flagged dead and leave the ring when they reach the front.
+/// A slot index stays valid until the missle leaves the ring
+/// \tparam capacity maximum number of missles (lifetime / reload time + margin)
+template<size_t capacity>
+class MisslePool
+{
+public:
+	static constexpr size_t CAPACITY = capacity;
+
+	/// \brief appends a missle
+	/// \return false if the ring is full (the missle is not added)
+	bool fire(const MissleData& missle)
+	{
+		if (m_count == capacity)
+			return false;
+
+		MissleData& m = m_slots[(m_first + m_count++) % capacity];
+		m = missle;
+		m.alive = true;
+		return true;
+	}
+
+	/// \brief removes dead and expired (lifetime < 0) missles from the front of the ring
+	void expire()
+	{
+		while (m_count > 0 && (!m_slots[m_first].alive || m_slots[m_first].lifetime < 0.0f))
+		{
+			m_slots[m_first].alive = false;
+			m_first = (m_first + 1) % capacity;
+			--m_count;
+		}
+	}
+
+	/// \brief removes all missles
+	void clear()
+	{
+		for (auto& m : m_slots)
+			m.alive = false;
+		m_first = 0;
+		m_count = 0;
+	}
+
+	/// \brief calls f(slot, missle) for all alive missles in fire order
+	template<class TFunc>
+	void forEach(TFunc&& f)
+	{
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			const size_t slot = (m_first + i) % capacity;
+			if (m_slots[slot].alive)
+				f(slot, m_slots[slot]);
+		}
+	}
+
+	template<class TFunc>
+	void forEach(TFunc&& f) const
+	{
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			const size_t slot = (m_first + i) % capacity;
+			if (m_slots[slot].alive)
+				f(slot, m_slots[slot]);
+		}
+	}
+
+	/// \return missle of a slot (alive = false for free slots)
+	MissleData& operator[](size_t slot) { return m_slots[slot]; }
+	const MissleData& operator[](size_t slot) const { return m_slots[slot]; }
+private:
+	std::array<MissleData, capacity> m_slots = {};
+	// oldest missle
+	size_t m_first = 0;
+	// number of used slots (including dead missles that did not reach the front yet)
+	size_t m_count = 0;
+};
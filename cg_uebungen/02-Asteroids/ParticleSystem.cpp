@@ -0,0 +1,114 @@
+#include "ParticleSystem.h"
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace glm;
+
+ParticleSystem::ParticleSystem(size_t capacity, uint32_t seed)
+	:
+	m_positionX(capacity),
+	m_positionY(capacity),
+	m_velocityX(capacity),
+	m_velocityY(capacity),
+	m_life(capacity),
+	m_invLifetime(capacity),
+	m_color(capacity),
+	m_drawX(capacity),
+	m_drawY(capacity),
+	m_drawColors(capacity),
+	m_twister(seed)
+{}
+
+void ParticleSystem::emitBurst(const vec2& position, const vec2& velocity, size_t count, float speed, float lifetime, const vec3& color)
+{
+	emitCone(position, velocity, 0.0f, 3.1415926f, count, speed, lifetime, color);
+}
+
+void ParticleSystem::emitCone(const vec2& position, const vec2& velocity, float angle, float spread, size_t count, float speed, float lifetime, const vec3& color)
+{
+	auto angleDist = std::uniform_real_distribution<float>(angle - spread, angle + spread);
+	auto unitDist = std::uniform_real_distribution<float>(0.25f, 1.0f);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float a = angleDist(m_twister);
+		const vec2 dir = vec2(-sin(a), cos(a));
+		add(position, velocity + dir * speed * unitDist(m_twister), lifetime * unitDist(m_twister), color * unitDist(m_twister));
+	}
+}
+
+void ParticleSystem::add(const vec2& position, const vec2& velocity, float lifetime, const vec3& color)
+{
+	if (m_count == m_positionX.size())
+		return;
+
+	const size_t i = m_count++;
+	m_positionX[i] = position.x;
+	m_positionY[i] = position.y;
+	m_velocityX[i] = velocity.x;
+	m_velocityY[i] = velocity.y;
+	m_life[i] = lifetime;
+	m_invLifetime[i] = 1.0f / lifetime;
+	m_color[i] = color;
+}
+
+void ParticleSystem::update(float dt)
+{
+	size_t i = 0;
+
+#ifdef __AVX2__
+	const __m256 vdt = _mm256_set1_ps(dt);
+	for (; i + 8 <= m_count; i += 8)
+	{
+		_mm256_storeu_ps(&m_positionX[i], _mm256_add_ps(_mm256_loadu_ps(&m_positionX[i]), _mm256_mul_ps(_mm256_loadu_ps(&m_velocityX[i]), vdt)));
+		_mm256_storeu_ps(&m_positionY[i], _mm256_add_ps(_mm256_loadu_ps(&m_positionY[i]), _mm256_mul_ps(_mm256_loadu_ps(&m_velocityY[i]), vdt)));
+		_mm256_storeu_ps(&m_life[i], _mm256_sub_ps(_mm256_loadu_ps(&m_life[i]), vdt));
+	}
+#endif
+
+	integrateScalar(i, m_count, dt);
+
+	// recycle expired particles (swap with the last one)
+	i = 0;
+	while (i < m_count)
+	{
+		if (m_life[i] > 0.0f)
+		{
+			++i;
+			continue;
+		}
+
+		const size_t last = --m_count;
+		m_positionX[i] = m_positionX[last];
+		m_positionY[i] = m_positionY[last];
+		m_velocityX[i] = m_velocityX[last];
+		m_velocityY[i] = m_velocityY[last];
+		m_life[i] = m_life[last];
+		m_invLifetime[i] = m_invLifetime[last];
+		m_color[i] = m_color[last];
+	}
+}
+
+void ParticleSystem::integrateScalar(size_t first, size_t last, float dt)
+{
+	for (size_t i = first; i < last; ++i)
+	{
+		m_positionX[i] += m_velocityX[i] * dt;
+		m_positionY[i] += m_velocityY[i] * dt;
+		m_life[i] -= dt;
+	}
+}
+
+void ParticleSystem::prepareDraw(float timeOffset) const
+{
+	for (size_t i = 0; i < m_count; ++i)
+	{
+		m_drawX[i] = m_positionX[i] + m_velocityX[i] * timeOffset;
+		m_drawY[i] = m_positionY[i] + m_velocityY[i] * timeOffset;
+		// fade out
+		m_drawColors[i] = m_color[i] * std::min(m_life[i] * m_invLifetime[i], 1.0f);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "../framework/glmmath.h"
+#include <vector>
+#include <random>
+#include <cstdint>
+
+/// \brief visual particles (explosions, thrust) in structure of arrays layout.
+/// The storage is allocated once, new particles are dropped if all slots are used.
+/// Particles have their own random numbers and do not influence the game state
+class ParticleSystem
+{
+public:
+	/// \param capacity maximum number of particles
+	/// \param seed seed of the random number generator
+	ParticleSystem(size_t capacity, uint32_t seed);
+
+	/// \brief spawns particles in all directions
+	/// \param position spawn position
+	/// \param velocity velocity of the source (added to all particles)
+	/// \param count number of particles
+	/// \param speed maximum speed relative to the source
+	/// \param lifetime maximum lifetime in milliseconds
+	/// \param color start color (fades to black)
+	void emitBurst(const glm::vec2& position, const glm::vec2& velocity, size_t count, float speed, float lifetime, const glm::vec3& color);
+
+	/// \brief spawns particles in a cone
+	/// \param angle direction of the cone (rotation of (0, 1) like Pipeline::setVertexRotation)
+	/// \param spread half opening angle of the cone
+	/// \see emitBurst for the other parameters
+	void emitCone(const glm::vec2& position, const glm::vec2& velocity, float angle, float spread, size_t count, float speed, float lifetime, const glm::vec3& color);
+
+	/// \brief moves all particles and removes the expired ones
+	/// \param dt time delta in milliseconds
+	void update(float dt);
+
+	/// \brief fills the draw buffers with the positions and the faded colors of all particles
+	/// \param timeOffset time in milliseconds that the positions are extrapolated (negative for interpolation)
+	void prepareDraw(float timeOffset) const;
+
+	/// \return draw buffers (count() entries, valid after prepareDraw())
+	const float* getDrawX() const { return m_drawX.data(); }
+	const float* getDrawY() const { return m_drawY.data(); }
+	const glm::vec3* getDrawColors() const { return m_drawColors.data(); }
+
+	/// \return number of active particles
+	size_t count() const { return m_count; }
+
+	/// \brief removes all particles
+	void clear() { m_count = 0; }
+private:
+	/// \brief adds a particle if a slot is free
+	void add(const glm::vec2& position, const glm::vec2& velocity, float lifetime, const glm::vec3& color);
+
+	/// \brief scalar version of the integration for [first, last)
+	void integrateScalar(size_t first, size_t last, float dt);
+private:
+	size_t m_count = 0;
+
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	// remaining lifetime and 1 / start lifetime
+	std::vector<float> m_life;
+	std::vector<float> m_invLifetime;
+	std::vector<glm::vec3> m_color;
+
+	// draw buffers (same capacity)
+	mutable std::vector<float> m_drawX;
+	mutable std::vector<float> m_drawY;
+	mutable std::vector<glm::vec3> m_drawColors;
+
+	std::mt19937 m_twister;
+};
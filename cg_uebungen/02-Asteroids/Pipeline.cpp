@@ -1,5 +1,6 @@
 #include "Pipeline.h"
 #include <array>
+#include <cmath>
 
 using namespace glm;
 
@@ -66,6 +67,13 @@ void Pipeline::drawClippedTriangle(std::array<Vertex, 3> vertices)
         vert.pos.y = (vert.pos.y + 1.0f) * 0.5f * m_height;
     }
 
+    // constant color => no interpolation or per pixel shading required
+    if (vertices[0].color == vertices[1].color && vertices[0].color == vertices[2].color)
+    {
+        drawFlatTriangle(vertices);
+        return;
+    }
+
     // Bottom-left rule
     const float fStart = vertices[0].pos.y;
     const float fMid = vertices[1].pos.y;
@@ -103,6 +111,34 @@ void Pipeline::drawClippedTriangle(std::array<Vertex, 3> vertices)
     }
 }
 
+void Pipeline::drawFlatTriangle(const std::array<Vertex, 3>& vertices)
+{
+    // the fragment shader result is the same for every pixel
+    const vec3 color = shadeFragment(vertices[0]);
+
+    const vec2 p0 = vertices[0].pos;
+    const vec2 p1 = vertices[1].pos;
+    const vec2 p2 = vertices[2].pos;
+    const int yStart = int(std::ceil(p0.y - 0.5f));
+    const int yMid = int(std::ceil(p1.y - 0.5f));
+    const int yEnd = int(std::ceil(p2.y - 0.5f));
+
+    // same edge interpolation as drawClippedTriangle, but only for x
+    for (int y = yStart; y < yMid; ++y)
+    {
+        float edge1 = p0.x + (float(y) + 0.5f - p0.y) / (p2.y - p0.y) * (p2.x - p0.x);
+        float edge2 = p0.x + (float(y) + 0.5f - p0.y) / (p1.y - p0.y) * (p1.x - p0.x);
+        scanLineFlat(y, std::min(edge1, edge2), std::max(edge1, edge2), color);
+    }
+
+    for (int y = yMid; y < yEnd; ++y)
+    {
+        float edge1 = p1.x + (float(y) + 0.5f - p1.y) / (p2.y - p1.y) * (p2.x - p1.x);
+        float edge2 = p0.x + (float(y) + 0.5f - p0.y) / (p2.y - p0.y) * (p2.x - p0.x);
+        scanLineFlat(y, std::min(edge1, edge2), std::max(edge1, edge2), color);
+    }
+}
+
 void Pipeline::clipPolygonComponent(const std::vector<Vertex>& in, std::vector<Vertex>& out, int axis, float side)
 {
     out.clear();
@@ -181,11 +217,16 @@ Pipeline::Pipeline(Window& window)
 
 void Pipeline::begin()
 {
+    // pick render target size (the window upscales it when presenting)
+    m_window.setRenderResolution(
+        size_t(std::lround(m_window.getWidth() * m_resolutionScale)),
+        size_t(std::lround(m_window.getHeight() * m_resolutionScale)));
+
     // clear window screen
     m_window.clear();
 
-    m_width = float(m_window.getWidth());
-    m_height = float(m_window.getHeight());
+    m_width = float(m_window.getRenderWidth());
+    m_height = float(m_window.getRenderHeight());
 }
 
 void Pipeline::scanLine(int y, const Vertex& left, const Vertex& right)
@@ -208,13 +249,32 @@ void Pipeline::scanLine(int y, const Vertex& left, const Vertex& right)
     const int xStart = int(std::ceil(fStart - 0.5f));
     const int xEnd = int(std::ceil(fEnd - 0.5f));
 
-    // draw pixels
+    if (xStart >= xEnd)
+        return;
+
+    // shade pixels into the span buffer
+    m_spanColors.resize(size_t(xEnd - xStart));
     for (int x = xStart; x < xEnd; ++x)
     {
         auto vert = Vertex::lerp(left, right, (float(x) + 0.5f - fStart) / (fEnd - fStart));
-        auto color = shadeFragment(vert);
-        m_window.putPixel(x, y, color.r, color.g, color.b);
+        m_spanColors[x - xStart] = shadeFragment(vert);
     }
+
+    // write the whole span at once
+    m_window.writeSpan(y, xStart, xEnd, m_spanColors.data());
+}
+
+void Pipeline::scanLineFlat(int y, float left, float right, const glm::vec3& color)
+{
+    dassert(left <= right);
+    dassert(left >= 0.0f);
+    dassert(right <= m_width);
+
+    // determine x start and end (bottom left rule)
+    const int xStart = int(std::ceil(left - 0.5f));
+    const int xEnd = int(std::ceil(right - 0.5f));
+    if (xStart < xEnd)
+        m_window.fillSpan(y, xStart, xEnd, color);
 }
 
 void Pipeline::shadeVertex(Vertex& vertex)
@@ -236,6 +296,58 @@ void Pipeline::drawTriangleList(const std::vector<Vertex>& vertices)
         drawTriangle(vertices[i], vertices[i + 1], vertices[i + 2]);
 }
 
+void Pipeline::drawSprite(const Sprite& sprite, const glm::vec2& translation)
+{
+    // sprite origin in pixels (rounded to the closest pixel corner)
+    const int originX = int(std::lround((translation.x + 1.0f) * 0.5f * m_width));
+    const int originY = int(std::lround((translation.y + 1.0f) * 0.5f * m_height));
+    const int width = int(m_width);
+    const int height = int(m_height);
+
+    for (size_t i = 0; i < sprite.spanCount; ++i)
+    {
+        const auto& span = sprite.spans[i];
+        const int y = originY + span.y;
+        if (y < 0 || y >= height)
+            continue;
+
+        // clip span to the screen
+        const int x0 = std::max(originX + span.x0, 0);
+        const int x1 = std::min(originX + span.x1, width);
+        if (x0 >= x1)
+            continue;
+
+        m_window.writeSpan(y, x0, x1, sprite.colors + span.color + (x0 - originX - span.x0));
+    }
+}
+
+void Pipeline::drawPoints(const float* x, const float* y, const glm::vec3* colors, size_t count, int size)
+{
+    const float scaleX = 0.5f * m_width;
+    const float scaleY = 0.5f * m_height;
+    const int width = int(m_width);
+    const int height = int(m_height);
+    const int offset = size / 2;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        // upper left corner in pixels
+        const int px = int(std::floor((x[i] + 1.0f) * scaleX)) - offset;
+        const int py = int(std::floor((y[i] + 1.0f) * scaleY)) - offset;
+
+        // clip square to the screen
+        const int x0 = std::max(px, 0);
+        const int x1 = std::min(px + size, width);
+        const int y0 = std::max(py, 0);
+        const int y1 = std::min(py + size, height);
+        if (x0 >= x1)
+            continue;
+
+        for (int row = y0; row < y1; ++row)
+            m_window.fillSpan(row, x0, x1, colors[i]);
+    }
+}
+
 void Pipeline::setVertexTranslation(const glm::vec2& translation)
 {
     m_translation = translation;
@@ -256,3 +368,10 @@ void Pipeline::setFragmentScale(float scale)
 {
     m_colorScale = scale;
 }
+
+void Pipeline::setResolutionScale(float scale)
+{
+    dassert(scale > 0.0f);
+    dassert(scale <= 1.0f);
+    m_resolutionScale = scale;
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "../framework/Window.h"
 #include "Vertex.h"
+#include "Sprite.h"
 #include <memory>
 
 class Pipeline
@@ -24,6 +25,25 @@ public:
 	/// \param vertices list of triangle vertices (multiple of three)
 	void drawTriangleList(const std::vector<Vertex>& vertices);
 
+	/// \brief copies a pre-rasterized sprite into the framebuffer (ignores the vertex and fragment settings)
+	/// \param sprite the sprite
+	/// \param translation position of the sprite origin in [-1, 1]
+	void drawSprite(const Sprite& sprite, const glm::vec2& translation);
+
+	/// \brief draws squares of solid color centered at the given points (ignores the vertex and fragment settings)
+	/// \param x point x coordinates in [-1, 1]
+	/// \param y point y coordinates in [-1, 1]
+	/// \param colors point colors
+	/// \param count number of points
+	/// \param size edge length of the squares in pixels
+	void drawPoints(const float* x, const float* y, const glm::vec3* colors, size_t count, int size);
+
+	/// \return width of the render target in pixels (valid after begin())
+	int getRenderWidth() const { return int(m_width); }
+
+	/// \return height of the render target in pixels (valid after begin())
+	int getRenderHeight() const { return int(m_height); }
+
 	/// \brief sets translation for the vertex shader
 	void setVertexTranslation(const glm::vec2& translation);
 
@@ -35,12 +55,27 @@ public:
 
 	/// \brief sets color scaling for the fragment shader
 	void setFragmentScale(float scale);
+
+	/// \brief sets the resolution of the render target relative to the window size (applied in begin())
+	/// \param scale resolution scale in (0, 1]
+	void setResolutionScale(float scale);
 private:
 	
 	/// \brief draws a triangle (vertices should be inside the canonical volume)
 	/// \param vertices array with the three triangle vertices
 	void drawClippedTriangle(std::array<Vertex, 3> vertices);
 
+	/// \brief draws a triangle with the same color at all vertices (no interpolation or per pixel shading)
+	/// \param vertices vertices in pixel coordinates sorted by y
+	void drawFlatTriangle(const std::array<Vertex, 3>& vertices);
+
+	/// \brief fills the scanline from left to right with a single color
+	/// \param y the height of the scanline
+	/// \param left the left x coordinate
+	/// \param right the right x coordinate
+	/// \param color the shaded color
+	void scanLineFlat(int y, float left, float right, const glm::vec3& color);
+
 	/// \brief draws the scanline with interpolated vertices from right.pos.x to left.pos.x
 	/// \param y the height of the scanline
 	/// \param left the left (x-axis) vertex
@@ -76,7 +111,10 @@ private:
 	float m_rotationCosine = 1.0f;
 	float m_scale = 1.0f;
 	float m_colorScale = 1.0f;
+	float m_resolutionScale = 1.0f;
 
 	std::vector<Vertex> m_triangleList;
 	std::vector<Vertex> m_triangleTmpList;
+	// shaded colors of the current scanline
+	std::vector<glm::vec3> m_spanColors;
 };
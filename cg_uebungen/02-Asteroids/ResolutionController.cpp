@@ -0,0 +1,48 @@
+#include "ResolutionController.h"
+#include <algorithm>
+#include <cmath>
+
+ResolutionController::ResolutionController(float budgetMs, float minScale)
+	:
+	m_budget(budgetMs),
+	m_minScale(minScale)
+{}
+
+void ResolutionController::addFrameTime(float frameMs)
+{
+	m_history[m_historyPos] = frameMs;
+	m_historyPos = (m_historyPos + 1) % s_historySize;
+	m_historyCount = std::min(m_historyCount + 1, s_historySize);
+
+	const float average = getAverageFrameTime();
+	if (average <= 0.0f)
+		return;
+
+	// the raster cost grows with the pixel count (scale squared)
+	const float ideal = m_targetScale * std::sqrt(m_budget / average);
+
+	if (average > m_budget)
+	{
+		// over budget: drop quickly, but at most 10% per frame
+		m_targetScale = std::max(ideal, m_targetScale * 0.9f);
+	}
+	else if (average < m_budget * 0.8f)
+	{
+		// enough headroom: recover slowly to avoid oscillation
+		m_targetScale = std::min(ideal, m_targetScale * 1.02f);
+	}
+	m_targetScale = std::clamp(m_targetScale, m_minScale, 1.0f);
+
+	m_scale = std::max(m_minScale, std::floor(m_targetScale / s_scaleStep) * s_scaleStep);
+}
+
+float ResolutionController::getAverageFrameTime() const
+{
+	if (m_historyCount == 0)
+		return 0.0f;
+
+	float sum = 0.0f;
+	for (size_t i = 0; i < m_historyCount; ++i)
+		sum += m_history[i];
+	return sum / float(m_historyCount);
+}
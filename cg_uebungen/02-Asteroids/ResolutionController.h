@@ -0,0 +1,37 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+/// \brief picks a render resolution scale based on the recently measured frame times
+class ResolutionController
+{
+public:
+	/// \param budgetMs target time for rendering a frame in milliseconds
+	/// \param minScale the resolution scale will never drop below this value
+	ResolutionController(float budgetMs, float minScale = 0.25f);
+
+	/// \brief adds a new frame time to the history and adjusts the resolution scale
+	/// \param frameMs measured frame time in milliseconds
+	void addFrameTime(float frameMs);
+
+	/// \return resolution scale in [minScale, 1] (multiply with the window size)
+	float getScale() const { return m_scale; }
+
+	/// \return average frame time of the history in milliseconds
+	float getAverageFrameTime() const;
+private:
+	// number of frames that are averaged
+	static constexpr size_t s_historySize = 16;
+	// scale changes are quantized to avoid reallocating the back buffer every frame
+	static constexpr float s_scaleStep = 1.0f / 64.0f;
+
+	float m_budget;
+	float m_minScale;
+	float m_scale = 1.0f;
+	// unquantized scale which changes smoothly
+	float m_targetScale = 1.0f;
+
+	std::array<float, s_historySize> m_history = {};
+	size_t m_historyPos = 0;
+	size_t m_historyCount = 0;
+};
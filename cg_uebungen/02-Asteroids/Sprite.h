@@ -0,0 +1,24 @@
+#pragma once
+#include "../framework/glmmath.h"
+#include <cstddef>
+
+/// \brief horizontal run of pixels of a pre-rasterized image
+struct SpriteSpan
+{
+	// row relative to the sprite origin
+	int y;
+	// first (inclusive) and last (exclusive) pixel relative to the sprite origin
+	int x0;
+	int x1;
+	// index of the color of the first pixel
+	size_t color;
+};
+
+/// \brief pre-rasterized image that can be copied into the framebuffer
+struct Sprite
+{
+	const SpriteSpan* spans = nullptr;
+	size_t spanCount = 0;
+	// color storage that is indexed by SpriteSpan::color
+	const glm::vec3* colors = nullptr;
+};
@@ -0,0 +1,192 @@
+#include "SpriteCache.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+using namespace glm;
+
+static constexpr float s_2pi = 6.28318530717958647692f;
+
+SpriteCache::SpriteCache(size_t rotations, size_t maxBytes)
+	:
+	m_rotations(std::max(rotations, size_t(1))),
+	m_maxBytes(maxBytes)
+{}
+
+int SpriteCache::addMesh(const std::vector<Vertex>& mesh, float scale)
+{
+	dassert(mesh.size() % 3 == 0);
+	m_meshes.push_back({ mesh, scale });
+	for (auto& atlas : m_atlases)
+		atlas.entries.resize(m_meshes.size() * m_rotations);
+	return int(m_meshes.size() - 1);
+}
+
+bool SpriteCache::get(int mesh, float rotation, int width, int height, Sprite& sprite)
+{
+	dassert(mesh >= 0 && mesh < int(m_meshes.size()));
+
+	// sprites are only valid for one render size
+	Atlas& atlas = getAtlas(width, height);
+
+	// closest quantized rotation
+	const float turns = rotation / s_2pi;
+	const long long quantized = std::llround((turns - std::floor(turns)) * float(m_rotations));
+	const size_t index = size_t(quantized) % m_rotations;
+
+	Entry& entry = atlas.entries[size_t(mesh) * m_rotations + index];
+	if (!entry.valid && !rasterize(m_meshes[mesh], index, atlas, entry))
+		return false;
+
+	sprite.spans = atlas.spans.data() + entry.firstSpan;
+	sprite.spanCount = entry.spanCount;
+	sprite.colors = atlas.colors.data();
+	return true;
+}
+
+size_t SpriteCache::getMemoryUsage() const
+{
+	size_t bytes = 0;
+	for (const auto& atlas : m_atlases)
+		bytes += atlas.getMemoryUsage();
+	return bytes;
+}
+
+size_t SpriteCache::Atlas::getMemoryUsage() const
+{
+	return spans.size() * sizeof(SpriteSpan) + colors.size() * sizeof(glm::vec3);
+}
+
+SpriteCache::Atlas& SpriteCache::getAtlas(int width, int height)
+{
+	auto it = std::find_if(m_atlases.begin(), m_atlases.end(), [&](const Atlas& a)
+		{
+			return a.width == width && a.height == height;
+		});
+
+	if (it == m_atlases.end())
+	{
+		Atlas atlas;
+		atlas.width = width;
+		atlas.height = height;
+		atlas.entries.resize(m_meshes.size() * m_rotations);
+		m_atlases.push_front(std::move(atlas));
+	}
+	else
+	{
+		m_atlases.splice(m_atlases.begin(), m_atlases, it);
+	}
+	return m_atlases.front();
+}
+
+bool SpriteCache::rasterize(const Mesh& mesh, size_t rotation, Atlas& atlas, Entry& entry)
+{
+	// vertex shader (see Pipeline::shadeVertex) and conversion to pixels relative to the sprite origin
+	const float angle = float(rotation) * s_2pi / float(m_rotations);
+	const float sine = sin(angle);
+	const float cosine = cos(angle);
+	const vec2 toPixels = vec2(float(atlas.width), float(atlas.height)) * 0.5f;
+
+	std::vector<Vertex> vertices = mesh.vertices;
+	vec2 minPos = vec2(std::numeric_limits<float>::max());
+	vec2 maxPos = -minPos;
+	for (auto& v : vertices)
+	{
+		const vec2 p = v.pos * mesh.scale;
+		v.pos = vec2(p.x * cosine - p.y * sine, p.y * cosine + p.x * sine) * toPixels;
+		minPos = min(minPos, v.pos);
+		maxPos = max(maxPos, v.pos);
+	}
+
+	// temporary image which covers the mesh bounds
+	m_bitmapX = int(std::floor(minPos.x)) - 1;
+	m_bitmapY = int(std::floor(minPos.y)) - 1;
+	m_bitmapWidth = int(std::ceil(maxPos.x)) + 1 - m_bitmapX;
+	m_bitmapHeight = int(std::ceil(maxPos.y)) + 1 - m_bitmapY;
+	m_bitmap.assign(size_t(m_bitmapWidth * m_bitmapHeight), vec3(0.0f));
+	m_coverage.assign(size_t(m_bitmapWidth * m_bitmapHeight), false);
+
+	for (size_t i = 0; i < vertices.size(); i += 3)
+		rasterizeTriangle(vertices[i], vertices[i + 1], vertices[i + 2]);
+
+	// convert covered runs into spans
+	const size_t spanStart = atlas.spans.size();
+	const size_t colorStart = atlas.colors.size();
+	for (int y = 0; y < m_bitmapHeight; ++y)
+	{
+		int x = 0;
+		while (x < m_bitmapWidth)
+		{
+			if (!m_coverage[y * m_bitmapWidth + x])
+			{
+				++x;
+				continue;
+			}
+
+			SpriteSpan span;
+			span.y = y + m_bitmapY;
+			span.x0 = x + m_bitmapX;
+			span.color = atlas.colors.size();
+			for (; x < m_bitmapWidth && m_coverage[y * m_bitmapWidth + x]; ++x)
+				atlas.colors.push_back(m_bitmap[y * m_bitmapWidth + x]);
+			span.x1 = x + m_bitmapX;
+			atlas.spans.push_back(span);
+		}
+	}
+
+	// over budget => drop the least recently used render sizes (the current atlas is the first)
+	while (getMemoryUsage() > m_maxBytes && m_atlases.size() > 1)
+		m_atlases.pop_back();
+
+	// still over budget => drop the sprite again
+	if (atlas.getMemoryUsage() > m_maxBytes)
+	{
+		atlas.spans.resize(spanStart);
+		atlas.colors.resize(colorStart);
+		return false;
+	}
+
+	entry.valid = true;
+	entry.firstSpan = spanStart;
+	entry.spanCount = atlas.spans.size() - spanStart;
+	return true;
+}
+
+void SpriteCache::rasterizeTriangle(Vertex v0, Vertex v1, Vertex v2)
+{
+	// same scanline rules as Pipeline::drawClippedTriangle and Pipeline::scanLine
+	std::array<Vertex, 3> vertices = { v0, v1, v2 };
+	std::sort(vertices.begin(), vertices.end(), [](const Vertex& a, const Vertex& b)
+		{
+			return a.pos.y < b.pos.y;
+		});
+
+	const float fStart = vertices[0].pos.y;
+	const float fMid = vertices[1].pos.y;
+	const float fEnd = vertices[2].pos.y;
+	const int yStart = int(std::ceil(fStart - 0.5f));
+	const int yMid = int(std::ceil(fMid - 0.5f));
+	const int yEnd = int(std::ceil(fEnd - 0.5f));
+
+	for (int y = yStart; y < yEnd; ++y)
+	{
+		const float fy = float(y) + 0.5f;
+		auto edge1 = Vertex::lerp(vertices[0], vertices[2], (fy - fStart) / (fEnd - fStart));
+		auto edge2 = y < yMid
+			? Vertex::lerp(vertices[0], vertices[1], (fy - fStart) / (fMid - fStart))
+			: Vertex::lerp(vertices[1], vertices[2], (fy - fMid) / (fEnd - fMid));
+		if (edge2.pos.x < edge1.pos.x)
+			std::swap(edge1, edge2);
+
+		const int xStart = int(std::ceil(edge1.pos.x - 0.5f));
+		const int xEnd = int(std::ceil(edge2.pos.x - 0.5f));
+		const int row = (y - m_bitmapY) * m_bitmapWidth;
+		for (int x = xStart; x < xEnd; ++x)
+		{
+			auto vert = Vertex::lerp(edge1, edge2, (float(x) + 0.5f - edge1.pos.x) / (edge2.pos.x - edge1.pos.x));
+			m_bitmap[row + x - m_bitmapX] = vert.color;
+			m_coverage[row + x - m_bitmapX] = true;
+		}
+	}
+}
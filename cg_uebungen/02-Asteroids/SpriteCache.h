@@ -0,0 +1,91 @@
+#pragma once
+#include "Vertex.h"
+#include "Sprite.h"
+#include <vector>
+#include <list>
+#include <cstdint>
+
+/// \brief caches rasterized images of rigid meshes at quantized rotations.
+/// Sprites are rasterized on demand and stored in one atlas per render size, so a dynamic resolution
+/// that switches between a few sizes keeps its sprites. The least recently used sizes are dropped
+/// when the memory budget is exceeded.
+class SpriteCache
+{
+public:
+	/// \param rotations number of quantized rotations per mesh
+	/// \param maxBytes memory budget of all atlases. No more sprites are rasterized if the atlas of the
+	/// current render size alone exceeds it
+	SpriteCache(size_t rotations = 64, size_t maxBytes = 16 * 1024 * 1024);
+
+	/// \brief registers a mesh
+	/// \param mesh triangle list (multiple of three)
+	/// \param scale scaling that is applied to the mesh (same as Pipeline::setVertexScale)
+	/// \return mesh id for get()
+	int addMesh(const std::vector<Vertex>& mesh, float scale);
+
+	/// \brief returns the sprite of the mesh with the closest quantized rotation
+	/// \param mesh id from addMesh()
+	/// \param rotation rotation angle (same as Pipeline::setVertexRotation)
+	/// \param width render target width in pixels
+	/// \param height render target height in pixels
+	/// \param sprite output sprite
+	/// \return false if the memory budget does not allow to cache the sprite
+	bool get(int mesh, float rotation, int width, int height, Sprite& sprite);
+
+	/// \return number of bytes used by all atlases
+	size_t getMemoryUsage() const;
+
+	/// \return number of cached render sizes
+	size_t getAtlasCount() const { return m_atlases.size(); }
+private:
+	struct Entry
+	{
+		bool valid = false;
+		size_t firstSpan = 0;
+		size_t spanCount = 0;
+	};
+	struct Mesh
+	{
+		std::vector<Vertex> vertices;
+		float scale;
+	};
+
+	/// \brief sprites of one render size
+	struct Atlas
+	{
+		int width = 0;
+		int height = 0;
+		// m_rotations entries per mesh
+		std::vector<Entry> entries;
+		std::vector<SpriteSpan> spans;
+		std::vector<glm::vec3> colors;
+
+		size_t getMemoryUsage() const;
+	};
+
+	/// \brief returns the atlas of the render size (created if needed) and marks it as most recently used
+	Atlas& getAtlas(int width, int height);
+
+	/// \brief rasterizes the mesh with the quantized rotation into the atlas
+	/// \return false if the memory budget was exceeded
+	bool rasterize(const Mesh& mesh, size_t rotation, Atlas& atlas, Entry& entry);
+
+	/// \brief rasterizes a triangle in pixel coordinates into m_bitmap (same rules as Pipeline)
+	void rasterizeTriangle(Vertex v0, Vertex v1, Vertex v2);
+private:
+	size_t m_rotations;
+	size_t m_maxBytes;
+
+	std::vector<Mesh> m_meshes;
+
+	// most recently used render size first
+	std::list<Atlas> m_atlases;
+
+	// temporary image for rasterization
+	std::vector<glm::vec3> m_bitmap;
+	std::vector<bool> m_coverage;
+	int m_bitmapX = 0;
+	int m_bitmapY = 0;
+	int m_bitmapWidth = 0;
+	int m_bitmapHeight = 0;
+};
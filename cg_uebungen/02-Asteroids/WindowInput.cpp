@@ -0,0 +1,85 @@
+#include "WindowInput.h"
+
+WindowInput::WindowInput(Window& window)
+{
+	window.setKeyDownCallback([this](Window::Key key)
+		{
+			switch (key)
+			{
+			case Window::Key::LEFT:
+			case Window::Key::A:
+				m_state.left = true;
+				break;
+			case Window::Key::RIGHT:
+			case Window::Key::D:
+				m_state.right = true;
+				break;
+			case Window::Key::UP:
+			case Window::Key::W:
+				m_state.thrust = true;
+				break;
+			case Window::Key::DOWN:
+			case Window::Key::S:
+				m_state.warp = true;
+				break;
+			case Window::Key::RIGHT_CONTROL:
+			case Window::Key::LEFT_CONTROL:
+			case Window::Key::SPACE:
+				m_state.fire = true;
+				break;
+			case Window::Key::R:
+				m_rewind = true;
+				break;
+			default:;
+			}
+		});
+
+	window.setKeyUpCallback([this](Window::Key key)
+		{
+			switch (key)
+			{
+			case Window::Key::LEFT:
+			case Window::Key::A:
+				m_state.left = false;
+				break;
+			case Window::Key::RIGHT:
+			case Window::Key::D:
+				m_state.right = false;
+				break;
+			case Window::Key::UP:
+			case Window::Key::W:
+				m_state.thrust = false;
+				break;
+			case Window::Key::RIGHT_CONTROL:
+			case Window::Key::LEFT_CONTROL:
+			case Window::Key::SPACE:
+				m_state.fire = false;
+				break;
+			case Window::Key::R:
+				m_rewind = false;
+				break;
+			case Window::Key::BACKSPACE:
+				m_state.reset = true;
+				break;
+			case Window::Key::T:
+				m_layoutToggle = true;
+				break;
+			default:;
+			}
+		});
+}
+
+InputState WindowInput::poll()
+{
+	InputState res = m_state;
+	m_state.warp = false;
+	m_state.reset = false;
+	return res;
+}
+
+bool WindowInput::pollLayoutToggle()
+{
+	const bool toggle = m_layoutToggle;
+	m_layoutToggle = false;
+	return toggle;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "InputSource.h"
+#include "../framework/Window.h"
+
+/// \brief keyboard controls of a window
+class WindowInput : public InputSource
+{
+public:
+	/// \brief installs the key callbacks of the window
+	explicit WindowInput(Window& window);
+
+	InputState poll() override;
+
+	/// \brief returns true while the rewind key (R) is held
+	bool isRewinding() const { return m_rewind; }
+
+	/// \brief returns true once after the back buffer layout key (T) was pressed
+	bool pollLayoutToggle();
+private:
+	InputState m_state;
+	bool m_rewind = false;
+	bool m_layoutToggle = false;
+};
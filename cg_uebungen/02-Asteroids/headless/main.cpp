@@ -0,0 +1,172 @@
+#include <exception>
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include "../Game.h"
+#include "../../framework/Timer.h"
+
+/// \brief deterministic input pattern (turns, thrusts, fires and warps periodically).
+/// The polled states can be recorded and replayed
+class ScriptedInput : public InputSource
+{
+public:
+	InputState poll() override
+	{
+		if (m_replaying && m_replayPos < m_log.size())
+			return m_log[m_replayPos++];
+
+		InputState s;
+		s.fire = true;
+		s.left = (m_tick / 500) % 2 == 0;
+		s.right = (m_tick / 1300) % 4 == 3;
+		s.thrust = (m_tick / 700) % 3 == 0;
+		s.warp = m_tick % 3000 == 2999;
+		s.reset = m_resetRequest;
+		m_resetRequest = false;
+		++m_tick;
+		if (m_recording)
+			m_log.push_back(s);
+		return s;
+	}
+
+	/// \brief restarts the game in the next update
+	void requestReset() { m_resetRequest = true; }
+
+	/// \brief starts a new input log
+	void record()
+	{
+		m_log.clear();
+		m_recording = true;
+		m_replaying = false;
+	}
+
+	/// \brief polls the recorded states (afterwards the script continues)
+	void replay()
+	{
+		m_recording = false;
+		m_replaying = true;
+		m_replayPos = 0;
+	}
+private:
+	uint64_t m_tick = 0;
+	bool m_resetRequest = false;
+
+	std::vector<InputState> m_log;
+	size_t m_replayPos = 0;
+	bool m_recording = false;
+	bool m_replaying = false;
+};
+
+// usage: headless [ticks] [asteroids per level (0 = default)] [seed] [grid (0/1)] [threads (0 = all cores)]
+int main(int argc, char** argv)
+{
+	try
+	{
+		const uint64_t numTicks = argc > 1 ? std::stoull(argv[1]) : 1000000;
+		const int numAsteroids = argc > 2 ? std::stoi(argv[2]) : 0;
+		const uint32_t seed = argc > 3 ? uint32_t(std::stoul(argv[3])) : 0;
+		const bool useGrid = argc > 4 ? std::stoi(argv[4]) != 0 : true;
+		const size_t numThreads = argc > 5 ? std::stoul(argv[5]) : 1;
+
+		// fixed time step for reproducible results
+		const float dt = Game::TICK_TIME;
+
+		ScriptedInput input;
+		Game game(input, seed);
+		game.setCollisionGrid(useGrid);
+		game.setThreadCount(numThreads);
+		if (numAsteroids > 0)
+		{
+			// restart with the new asteroid count
+			game.setAsteroidsPerLevel(numAsteroids);
+			input.requestReset();
+		}
+
+		uint64_t gameOvers = 0;
+		size_t maxAsteroids = 0;
+		int bestScore = 0;
+
+		Timer t;
+		t.start();
+		for (uint64_t tick = 0; tick < numTicks; ++tick)
+		{
+			game.update(dt);
+			maxAsteroids = std::max(maxAsteroids, game.getAsteroidCount());
+			bestScore = std::max(bestScore, game.getScore());
+			if (game.isGameOver())
+			{
+				++gameOvers;
+				input.requestReset();
+			}
+		}
+		const float timeMs = t.stop();
+
+		std::cout << "ticks: " << numTicks
+			<< " | time: " << timeMs << " ms"
+			<< " | ticks/s: " << uint64_t(double(numTicks) * 1000.0 / std::max(double(timeMs), 1e-3)) << "\n"
+			<< "threads: " << numThreads
+			<< " | seed: " << seed
+			<< " | max asteroids: " << maxAsteroids
+			<< " | game overs: " << gameOvers
+			<< " | level: " << game.getLevel()
+			<< " | score: " << game.getScore()
+			<< " | best score: " << bestScore << "\n";
+
+		// snapshot capture time
+		const int numCaptures = 100;
+		SnapshotRing ring(numCaptures);
+		t.start();
+		for (int i = 0; i < numCaptures; ++i)
+			game.saveSnapshot(ring.push());
+		const float firstCaptureMs = t.stop();
+		t.start();
+		for (int i = 0; i < numCaptures; ++i)
+			game.saveSnapshot(ring.push());
+		const float captureMs = t.stop();
+
+		t.start();
+		for (int i = 0; i < numCaptures; ++i)
+			game.loadSnapshot(*ring.pop());
+		const float restoreMs = t.stop();
+
+		GameSnapshot start;
+		game.saveSnapshot(start);
+		std::cout << "snapshot: " << start.getSize() << " bytes"
+			<< " | capture: " << captureMs * 1000.0f / numCaptures << " us"
+			<< " (first: " << firstCaptureMs * 1000.0f / numCaptures << " us)"
+			<< " | restore: " << restoreMs * 1000.0f / numCaptures << " us\n";
+
+		// replay: the same snapshot and input log must give the same state
+		const uint64_t replayTicks = std::min<uint64_t>(numTicks, 1000);
+		input.record();
+		for (uint64_t tick = 0; tick < replayTicks; ++tick)
+		{
+			game.update(dt);
+			if (game.isGameOver())
+				input.requestReset();
+		}
+		GameSnapshot recorded;
+		game.saveSnapshot(recorded);
+
+		game.loadSnapshot(start);
+		input.replay();
+		for (uint64_t tick = 0; tick < replayTicks; ++tick)
+			game.update(dt);
+		GameSnapshot replayed;
+		game.saveSnapshot(replayed);
+
+		const bool replayOk = recorded.getSize() == replayed.getSize() &&
+			std::equal(recorded.data(), recorded.data() + recorded.getSize(), replayed.data());
+		std::cout << "replay of " << replayTicks << " ticks: " << (replayOk ? "identical" : "MISMATCH") << "\n";
+		if (!replayOk)
+			return 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "ERR: " << e.what();
+		return 1;
+	}
+	return 0;
+}
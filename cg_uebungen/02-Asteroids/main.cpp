@@ -1,9 +1,13 @@
 #include <exception>
 #include <iostream>
+#include <random>
+#include <algorithm>
 #include "../framework/Window.h"
 #include "Pipeline.h"
 #include "../framework/Timer.h"
 #include "Game.h"
+#include "WindowInput.h"
+#include "ResolutionController.h"
 
 using namespace glm;
 
@@ -17,37 +21,70 @@ int main()
 		Timer t;
 		t.start();
 
-		Game game(wnd);
+		WindowInput input(wnd);
+		Game game(input, std::random_device()());
+		game.setThreadCount(0);
+		// asteroids are drawn from sprites at quantized rotations (0 = always rasterize the meshes)
+		const size_t spriteRotations = 64;
+		game.setSpriteCache(spriteRotations);
+
+		// render resolution follows the frame time (budget for 60 fps)
+		ResolutionController resolution(16.0f);
+
+		// game states of the last 10 seconds (hold R to rewind), preallocated for up to 256 asteroids
+		const size_t rewindAsteroids = 256;
+		SnapshotRing rewind(size_t(10000.0f / Game::TICK_TIME), Game::getSnapshotSize(rewindAsteroids));
+
+		// simulation time that was not yet processed by fixed updates
+		float accumulator = 0.0f;
+		// drop time after slow frames instead of catching up with more updates
+		const int maxUpdatesPerFrame = 8;
 
 		while (wnd.isOpen())
 		{
 			// time delta in milliseconds
 			auto dt = t.lap();
-			game.update(dt);
+			accumulator = std::min(accumulator + dt, maxUpdatesPerFrame * Game::TICK_TIME);
+			while (accumulator >= Game::TICK_TIME)
+			{
+				if (input.isRewinding())
+				{
+					// go back one update per tick
+					if (const GameSnapshot* s = rewind.pop())
+						game.loadSnapshot(*s);
+				}
+				else
+				{
+					game.saveSnapshot(rewind.push());
+					game.update(Game::TICK_TIME);
+				}
+				accumulator -= Game::TICK_TIME;
+			}
 
-			pipe.begin();
+			// switch between the linear and the tiled back buffer (T)
+			if (input.pollLayoutToggle())
+			{
+#ifdef _DEBUG
+				// debug builds check the tiled layout against the linear one first
+				if (!wnd.isTiledLayout())
+					dassert(wnd.testTiledLayout());
+#endif
+				wnd.setTiledLayout(!wnd.isTiledLayout());
+			}
 
-			//game.draw(pipe);
-
-			// (Aufgabe 1) Dreieck in OpenGL Koordinaten:
-			pipe.drawTriangle(
-				Vertex(vec2(0.7f, 0.9f), vec3(1.0f, 0.0f, 0.0f)),
-				Vertex(vec2(-0.6f, -0.1f), vec3(0.0f, 1.0f, 0.0f)),
-				Vertex(vec2(0.6f, -0.7f), vec3(0.0f, 0.0f, 1.0f))
-			);
-
-			// (Aufgabe 2) Dreieck ausserhalb des Bildschirms (wird aktuell nicht gemalt weil ausserhalb):
-			pipe.drawTriangle(
-				Vertex(vec2(-1.2f, 0.7f), vec3(1.0f, 0.0f, 0.0f)),
-				Vertex(vec2(1.3f, 0.6f), vec3(0.0f, 1.0f, 0.0f)),
-				Vertex(vec2(0.0f, -1.4f), vec3(0.0f, 0.0f, 1.0f))
-			);
+			pipe.setResolutionScale(resolution.getScale());
+			pipe.begin();
 
+			// interpolate between the last two updates
+			game.draw(pipe, accumulator / Game::TICK_TIME);
 
 			// measure time before buffer swap
 			auto timeMs = t.current();
+			resolution.addFrameTime(timeMs);
 			wnd.setTitle("Software Renderer | " + std::to_string(timeMs) + 
-				" ms | level: " + std::to_string(game.getLevel()) + 
+				" ms | " + std::to_string(wnd.getRenderWidth()) + "x" + std::to_string(wnd.getRenderHeight()) +
+				(wnd.isTiledLayout() ? " tiled" : "") +
+				" | level: " + std::to_string(game.getLevel()) + 
 				" | score: " + std::to_string(game.getScore()));
 
 			wnd.swapBuffer();
@@ -0,0 +1,268 @@
+#include "CdlodTerrain.h"
+#include "Terrain.h"
+#include "GridMesh.h"
+#include "NoiseKernel.h"
+#include "../framework/ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+using namespace glm;
+
+CdlodTerrain::CdlodTerrain(float perlinRes, int octaves, const Settings& settings)
+    : m_settings(settings),
+      m_perlinRes(perlinRes),
+      m_octaves(octaves)
+{
+    const int gridSize = m_settings.gridSize;
+    const int quads = m_settings.heightmapResolution - 1;
+    // der Quadtree braucht gridSize * 2^n Quads, die Patch-Indizes müssen in 16 Bit passen
+    if (gridSize < 2 || (gridSize + 1) * (gridSize + 1) > int(BasicIndexBuffer<uint16_t>::RESTART_INDEX)
+        || quads < gridSize || quads % gridSize != 0 || ((quads / gridSize) & (quads / gridSize - 1)) != 0)
+        throw std::runtime_error("CdlodTerrain: heightmap resolution must be gridSize * 2^n + 1");
+
+    m_levelCount = 1;
+    while ((gridSize << (m_levelCount - 1)) < quads)
+        ++m_levelCount;
+
+    // Sichtweite pro Level: jenseits davon wird das nächste Level gezeichnet, also ab der Entfernung,
+    // in der ein Quad des nächsten Levels höchstens pixelError Pixel groß ist
+    const float pixelsPerUnit = m_settings.viewportHeight / (2.0f * std::tan(0.5f * m_settings.fieldOfView));
+    m_ranges.resize(m_levelCount);
+    for (int level = 0; level < m_levelCount; ++level)
+    {
+        const float quadSize = 2.0f / float(quads) * float(2 << level);
+        m_ranges[level] = quadSize * pixelsPerUnit / m_settings.pixelError;
+    }
+
+    generate();
+    buildMinMax();
+
+    fillGridStrips(m_indices, gridSize + 1);
+
+    m_program
+        .attach(Shader(GL_VERTEX_SHADER).loadFromFile("shader/cdlod.vert"))
+        .attach(Shader(GL_FRAGMENT_SHADER).loadFromFile("shader/terrain.frag"))
+        .link();
+
+    m_uniformTransform = m_program.getUniform<glm::mat4>("u_transform", glm::mat4(1.0f));
+    m_uniformHeightScale = m_program.getUniform<float>("u_heightScale", 1.0f);
+    m_uniformHeightmap = m_program.getUniform<GLint>("u_heightmap", 0);
+    m_uniformHeightmapSize = m_program.getUniform<GLint>("u_heightmapSize", m_settings.heightmapResolution);
+    m_uniformHeightRange = m_program.getUniform<glm::vec2>("u_heightRange", m_heightRange);
+    m_uniformNode = m_program.getUniform<glm::vec3>("u_node", glm::vec3(0.0f));
+    m_uniformGridSize = m_program.getUniform<GLint>("u_gridSize", gridSize);
+    m_uniformMorphRange = m_program.getUniform<glm::vec2>("u_morphRange", glm::vec2(0.0f, 1.0f));
+    m_uniformCamera = m_program.getUniform<glm::vec3>("u_camera", glm::vec3(0.0f));
+}
+
+void CdlodTerrain::generate()
+{
+    const int resolution = m_settings.heightmapResolution;
+    const size_t sampleCount = size_t(resolution) * size_t(resolution);
+    std::vector<float> heights(sampleCount);
+    NoiseKernel noise(TERRAIN_SEED);
+    ThreadPool threadPool(m_settings.numThreads);
+
+    // Gradienten-Cache pro Oktave wie in Terrain::buildLattices
+    std::vector<NoiseKernel::Lattice> lattices(m_octaves);
+    float frequency = 1.0f;
+    for (int i = 0; i < m_octaves; ++i)
+    {
+        const int size = static_cast<int>(std::floor((m_perlinRes * 0.9f) * frequency)) + 2;
+        if (size_t(size) * size_t(size) <= sampleCount)
+            noise.buildLattice(0, 0, size, size, lattices[i]);
+        frequency *= OCTAVE_FREQUENCY;
+    }
+
+    float maxAmplitude = 0.0f;
+    float amplitude = 1.0f;
+    for (int i = 0; i < m_octaves; ++i)
+    {
+        maxAmplitude += amplitude;
+        amplitude *= OCTAVE_AMPLITUDE;
+    }
+
+    // dieselben Höhen wie Terrain::generateRows, nur ohne Oktaven-Layer
+    threadPool.parallelFor(resolution, 4, [&](size_t, size_t first, size_t last)
+        {
+            std::vector<float> sampleX(resolution);
+            std::vector<float> sampleZ(resolution);
+            std::vector<float> row(resolution);
+            std::vector<float> total(resolution);
+
+            for (int z = int(first); z < int(last); ++z) {
+                float perlinZ = (static_cast<float>(z) / (resolution - 1)) * (m_perlinRes * 0.9f);
+
+                std::fill(total.begin(), total.end(), 0.0f);
+                float frequency = 1.0f;
+                float amplitude = 1.0f;
+                for (int i = 0; i < m_octaves; ++i) {
+                    for (int x = 0; x < resolution; ++x) {
+                        float perlinX = (static_cast<float>(x) / (resolution - 1)) * (m_perlinRes * 0.9f);
+                        sampleX[x] = perlinX * frequency;
+                        sampleZ[x] = perlinZ * frequency;
+                    }
+
+                    if (lattices[i].directionX.empty())
+                        noise.evaluate(sampleX.data(), sampleZ.data(), row.data(), row.size());
+                    else
+                        noise.evaluate(lattices[i], sampleX.data(), sampleZ.data(), row.data(), row.size());
+
+                    for (int x = 0; x < resolution; ++x)
+                        total[x] += row[x] * amplitude;
+
+                    frequency *= OCTAVE_FREQUENCY;
+                    amplitude *= OCTAVE_AMPLITUDE;
+                }
+
+                float* out = heights.data() + size_t(z) * size_t(resolution);
+                for (int x = 0; x < resolution; ++x)
+                    out[x] = (total[x] / maxAmplitude) * 0.5f * 1.2f;
+            }
+        });
+
+    // auf [0, 65535] normalisieren (GL_R16 liefert im Shader [0, 1])
+    const auto range = std::minmax_element(heights.begin(), heights.end());
+    const float minHeight = *range.first;
+    const float extent = *range.second - minHeight;
+    m_heightRange = glm::vec2(minHeight, extent);
+
+    m_heights.resize(sampleCount);
+    for (size_t i = 0; i < sampleCount; ++i)
+    {
+        const float normalized = extent > 0.0f ? (heights[i] - minHeight) / extent * 65535.0f : 0.0f;
+        m_heights[i] = uint16_t(std::min(std::lround(normalized), 65535L));
+    }
+
+    m_heightmap.uploadToGpu(resolution, resolution, m_heights.data());
+}
+
+void CdlodTerrain::buildMinMax()
+{
+    const int gridSize = m_settings.gridSize;
+    m_minMax.resize(m_levelCount);
+
+    // Level 0 aus den Texeln (inklusive der geteilten Ränder)
+    int nodesPerSide = getNodesPerSide(0);
+    m_minMax[0].resize(size_t(nodesPerSide) * size_t(nodesPerSide));
+    for (int nodeZ = 0; nodeZ < nodesPerSide; ++nodeZ)
+    {
+        for (int nodeX = 0; nodeX < nodesPerSide; ++nodeX)
+        {
+            vec2 minMax = vec2(getHeight(nodeX * gridSize, nodeZ * gridSize));
+            for (int z = nodeZ * gridSize; z <= (nodeZ + 1) * gridSize; ++z)
+            {
+                for (int x = nodeX * gridSize; x <= (nodeX + 1) * gridSize; ++x)
+                {
+                    const float height = getHeight(x, z);
+                    minMax = vec2(std::min(minMax.x, height), std::max(minMax.y, height));
+                }
+            }
+            m_minMax[0][size_t(nodeZ) * size_t(nodesPerSide) + size_t(nodeX)] = minMax;
+        }
+    }
+
+    // höhere Level aus den vier Kindern
+    for (int level = 1; level < m_levelCount; ++level)
+    {
+        const int childrenPerSide = nodesPerSide;
+        nodesPerSide = getNodesPerSide(level);
+        m_minMax[level].resize(size_t(nodesPerSide) * size_t(nodesPerSide));
+        for (int nodeZ = 0; nodeZ < nodesPerSide; ++nodeZ)
+        {
+            for (int nodeX = 0; nodeX < nodesPerSide; ++nodeX)
+            {
+                vec2 minMax = vec2(FLT_MAX, -FLT_MAX);
+                for (int i = 0; i < 4; ++i)
+                {
+                    const vec2 child = m_minMax[level - 1][size_t(nodeZ * 2 + (i >> 1)) * size_t(childrenPerSide) + size_t(nodeX * 2 + (i & 1))];
+                    minMax = vec2(std::min(minMax.x, child.x), std::max(minMax.y, child.y));
+                }
+                m_minMax[level][size_t(nodeZ) * size_t(nodesPerSide) + size_t(nodeX)] = minMax;
+            }
+        }
+    }
+}
+
+void CdlodTerrain::update(const glm::vec2& camera)
+{
+    // Auge über dem Terrain an der Kamera (außerhalb über dem Rand)
+    const int maxTexel = m_settings.heightmapResolution - 1;
+    const int texelX = int(std::lround((glm::clamp(camera.x, -1.0f, 1.0f) * 0.5f + 0.5f) * float(maxTexel)));
+    const int texelZ = int(std::lround((glm::clamp(camera.y, -1.0f, 1.0f) * 0.5f + 0.5f) * float(maxTexel)));
+    m_eye = vec3(camera.x, getHeight(texelX, texelZ) + m_settings.eyeHeight, camera.y);
+
+    m_selection.clear();
+    selectNode(m_levelCount - 1, 0, 0);
+}
+
+bool CdlodTerrain::selectNode(int level, int nodeX, int nodeZ)
+{
+    // die Wurzel wird immer gezeichnet
+    if (level < m_levelCount - 1 && !intersects(level, nodeX, nodeZ, m_ranges[level]))
+        return false;
+
+    const int size = m_settings.gridSize << level;
+    if (level == 0 || !intersects(level, nodeX, nodeZ, m_ranges[level - 1]))
+    {
+        m_selection.push_back({ nodeX * size, nodeZ * size, level });
+        return true;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        const int childX = nodeX * 2 + (i & 1);
+        const int childZ = nodeZ * 2 + (i >> 1);
+        // Kinder außerhalb ihres Bereichs sind vollständig gemorpht und sehen aus wie dieses Level
+        if (!selectNode(level - 1, childX, childZ))
+            m_selection.push_back({ childX * (size / 2), childZ * (size / 2), level - 1 });
+    }
+    return true;
+}
+
+bool CdlodTerrain::intersects(int level, int nodeX, int nodeZ, float radius) const
+{
+    const int size = m_settings.gridSize << level;
+    const vec2 minMax = m_minMax[level][size_t(nodeZ) * size_t(getNodesPerSide(level)) + size_t(nodeX)];
+    const vec3 boxMin = vec3(toTerrain(nodeX * size), minMax.x, toTerrain(nodeZ * size));
+    const vec3 boxMax = vec3(toTerrain((nodeX + 1) * size), minMax.y, toTerrain((nodeZ + 1) * size));
+
+    // nächster Punkt der Box zum Auge
+    const vec3 closest = glm::clamp(m_eye, boxMin, boxMax);
+    const vec3 delta = closest - m_eye;
+    return glm::dot(delta, delta) <= radius * radius;
+}
+
+void CdlodTerrain::draw(const glm::mat4& transform, float heightScale)
+{
+    m_program.bind();
+    m_heightmap.bind(0);
+
+    m_uniformTransform.set(transform);
+    m_uniformHeightScale.set(heightScale);
+    m_uniformCamera.set(m_eye);
+
+    for (const Node& node : m_selection)
+    {
+        // Morph im hinteren Teil des Levelbereichs
+        const float previousRange = node.level > 0 ? m_ranges[node.level - 1] : 0.0f;
+        const float range = m_ranges[node.level];
+        m_uniformMorphRange.set(vec2(previousRange + (range - previousRange) * m_settings.morphStart, range));
+        m_uniformNode.set(vec3(float(node.x), float(node.z), float(m_settings.gridSize << node.level)));
+
+        m_vao.drawElements(GL_TRIANGLE_STRIP, m_program, m_indices, true);
+    }
+}
+
+float CdlodTerrain::getHeight(int x, int z) const
+{
+    const size_t index = size_t(z) * size_t(m_settings.heightmapResolution) + size_t(x);
+    return m_heightRange.x + float(m_heights[index]) / 65535.0f * m_heightRange.y;
+}
+
+float CdlodTerrain::toTerrain(int texel) const
+{
+    return float(texel) / float(m_settings.heightmapResolution - 1) * 2.0f - 1.0f;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "../framework/VertexArrayObject.h"
+#include "../framework/Uniform.h"
+#include "../framework/IndexBuffer.h"
+#include "../framework/Program.h"
+#include "../framework/Texture2D.h"
+
+/// \brief Terrain mit Continuous Distance-Dependent Level of Detail (CDLOD).
+/// Die Höhen liegen in einer Heightmap-Textur, die weit größer als das Gitter von Terrain sein kann.
+/// Pro Frame wird aus einem Quadtree anhand der Kameraposition und einer Fehlerschranke in Pixeln
+/// eine Menge von Knoten ausgewählt. Jeder Knoten wird als Patch mit gridSize^2 Quads gezeichnet,
+/// der Vertex-Shader liest die Höhen aus der Textur und morpht zum Gitter des nächsten Levels,
+/// damit beim Levelwechsel nichts springt. Die Dreiecksanzahl hängt nur von der Fehlerschranke ab
+class CdlodTerrain
+{
+public:
+	struct Settings
+	{
+		// Texel pro Heightmap-Seite (gridSize * 2^n + 1)
+		int heightmapResolution = 2049;
+		// Quads pro Patch-Seite (Zweierpotenz)
+		int gridSize = 32;
+		// erlaubte Kantenlänge eines Quads auf dem Bildschirm in Pixeln
+		float pixelError = 4.0f;
+		// gedachte Perspektive für die Fehlerschranke
+		float viewportHeight = 600.0f;
+		float fieldOfView = 1.0472f; // 60 Grad
+		// Anteil des Levelbereichs, ab dem zum nächsten Level gemorpht wird
+		float morphStart = 0.7f;
+		// Augenhöhe über dem Terrain
+		float eyeHeight = 0.05f;
+		// Threads für die Generierung (0 = alle Kerne)
+		size_t numThreads = 0;
+	};
+
+	/// \param perlinRes und octaves wie bei Terrain (gleiches Terrain, höhere Auflösung)
+	CdlodTerrain(float perlinRes, int octaves, const Settings& settings);
+
+	/// \brief wählt die Knoten für die Kamera aus
+	/// \param camera Kameraposition im Terrain-Raum (x, z in [-1, 1])
+	void update(const glm::vec2& camera);
+
+	/// \brief zeichnet die ausgewählten Knoten. Das Terrain füllt [-1, 1] wie Terrain
+	/// \param heightScale Höhenskalierung im Shader (siehe Terrain::getRelativeHeightScale)
+	void draw(const glm::mat4& transform, float heightScale);
+
+	float getPerlinResolution() const { return m_perlinRes; }
+	int getOctaves() const { return m_octaves; }
+	/// \return Anzahl der ausgewählten Knoten
+	size_t getNodeCount() const { return m_selection.size(); }
+	/// \return Anzahl der gezeichneten Dreiecke
+	size_t getTriangleCount() const { return m_selection.size() * size_t(m_settings.gridSize) * size_t(m_settings.gridSize) * 2; }
+
+private:
+	struct Node
+	{
+		// Ecke in Texeln
+		int x;
+		int z;
+		int level;
+	};
+
+	/// \brief berechnet die Höhen und lädt sie als Textur hoch
+	void generate();
+	/// \brief Minimum und Maximum der Höhen pro Knoten und Level
+	void buildMinMax();
+	/// \brief wählt den Knoten oder seine Kinder aus
+	/// \return false, wenn der Knoten außerhalb seines Levelbereichs liegt (der Elternknoten zeichnet ihn dann)
+	bool selectNode(int level, int nodeX, int nodeZ);
+	/// \brief schneidet die Bounding-Box des Knotens die Kugel um das Auge?
+	bool intersects(int level, int nodeX, int nodeZ, float radius) const;
+	/// \return Knotenanzahl pro Seite des Levels
+	int getNodesPerSide(int level) const { return (m_settings.heightmapResolution - 1) / (m_settings.gridSize << level); }
+	float getHeight(int x, int z) const;
+	/// \brief Umrechnung von Texeln in den Terrain-Raum [-1, 1]
+	float toTerrain(int texel) const;
+
+private:
+	Settings m_settings;
+	float m_perlinRes;
+	int m_octaves;
+	int m_levelCount = 0;
+
+	// normalisierte Höhen, Minimum und Umfang
+	std::vector<uint16_t> m_heights;
+	glm::vec2 m_heightRange = glm::vec2(0.0f);
+	Texture2D m_heightmap;
+
+	// Minimum und Maximum pro Knoten, [level][z * nodesPerSide + x]
+	std::vector<std::vector<glm::vec2>> m_minMax;
+	// Sichtweite pro Level (Fehlerschranke), das oberste Level ist immer sichtbar
+	std::vector<float> m_ranges;
+
+	glm::vec3 m_eye = glm::vec3(0.0f);
+	std::vector<Node> m_selection;
+
+	// Patch-Indizes, die Vertices berechnet der Shader aus gl_VertexID
+	BasicIndexBuffer<uint16_t> m_indices;
+	VertexArrayObject m_vao;
+	Program m_program;
+
+	Uniform<glm::mat4> m_uniformTransform;
+	Uniform<float> m_uniformHeightScale;
+	Uniform<GLint> m_uniformHeightmap;
+	Uniform<GLint> m_uniformHeightmapSize;
+	Uniform<glm::vec2> m_uniformHeightRange;
+	Uniform<glm::vec3> m_uniformNode;
+	Uniform<GLint> m_uniformGridSize;
+	Uniform<glm::vec2> m_uniformMorphRange;
+	Uniform<glm::vec3> m_uniformCamera;
+};
@@ -0,0 +1,277 @@
+#include "ChunkedTerrain.h"
+#include "Terrain.h"
+#include "GridMesh.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace glm;
+
+ChunkedTerrain::ChunkedTerrain(const Settings& settings)
+    : m_settings(settings)
+{
+    const int resolution = m_settings.chunkResolution;
+    // alle Vertex-Indizes müssen kleiner als der 16-Bit-Restart-Index sein
+    if (resolution < 2 || resolution * resolution > int(BasicIndexBuffer<uint16_t>::RESTART_INDEX))
+        throw std::runtime_error("ChunkedTerrain: chunk resolution must be in [2, 255]");
+
+    fillGridStrips(m_indices, resolution);
+
+    // derselbe Shader wie Terrain im kompakten Modus
+    m_program
+        .attach(Shader(GL_VERTEX_SHADER).loadFromFile("shader/terrain.vert"))
+        .attach(Shader(GL_FRAGMENT_SHADER).loadFromFile("shader/terrain.frag"))
+        .link();
+
+    m_uniformTransform = m_program.getUniform<glm::mat4>("u_transform", glm::mat4(1.0f));
+    m_uniformHeightScale = m_program.getUniform<float>("u_heightScale", 1.0f);
+    m_uniformCompact = m_program.getUniform<GLint>("u_compact", 1);
+    m_uniformResolution = m_program.getUniform<GLint>("u_resolution", resolution);
+    // feste Quantisierung, damit gleiche Höhen an den Rändern gleiche Werte ergeben
+    m_uniformHeightRange = m_program.getUniform<glm::vec2>("u_heightRange", glm::vec2(0.0f, MAX_TERRAIN_HEIGHT / 65535.0f));
+
+    // Worker starten
+    size_t numThreads = m_settings.numThreads;
+    if (numThreads == 0)
+        numThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    for (size_t i = 0; i < numThreads; ++i)
+        m_workers.emplace_back([this]() { workerLoop(); });
+}
+
+ChunkedTerrain::~ChunkedTerrain()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+void ChunkedTerrain::update(const glm::vec2& camera)
+{
+    m_camera = camera;
+    m_cameraChunk = getChunkKey(camera);
+    const int radius = m_settings.viewRadius;
+    auto isVisible = [&](const ChunkKey& key)
+    {
+        return std::abs(key.x - m_cameraChunk.x) <= radius && std::abs(key.z - m_cameraChunk.z) <= radius;
+    };
+    // sortiert so, dass der nächste Chunk hinten liegt
+    auto fartherFirst = [&](const ChunkKey& a, const ChunkKey& b)
+    {
+        return distance2(a, m_cameraChunk) > distance2(b, m_cameraChunk);
+    };
+
+    // fertige Chunks übernehmen, die nächsten zuerst und höchstens uploadsPerFrame
+    std::vector<ChunkData> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::sort(m_finished.begin(), m_finished.end(), [&](const ChunkData& a, const ChunkData& b) { return fartherFirst(a.key, b.key); });
+        while (int(ready.size()) < m_settings.uploadsPerFrame && !m_finished.empty())
+        {
+            ready.push_back(std::move(m_finished.back()));
+            m_finished.pop_back();
+            m_scheduled.erase(ready.back().key);
+        }
+    }
+
+    for (auto& data : ready)
+    {
+        // inzwischen nicht mehr sichtbare Chunks werden verworfen (und bei Bedarf neu angefordert)
+        if (isVisible(data.key))
+            upload(data);
+    }
+
+    // sichtbare Chunks im LRU nach vorne, fehlende anfordern
+    std::vector<ChunkKey> missing;
+    for (int z = m_cameraChunk.z - radius; z <= m_cameraChunk.z + radius; ++z)
+    {
+        for (int x = m_cameraChunk.x - radius; x <= m_cameraChunk.x + radius; ++x)
+        {
+            const ChunkKey key = { x, z };
+            auto it = m_chunks.find(key);
+            if (it != m_chunks.end())
+                m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            else
+                missing.push_back(key);
+        }
+    }
+    std::sort(missing.begin(), missing.end(), fartherFirst);
+
+    {
+        // alte Anforderungen (z.B. hinter der Kamera) werden ersetzt
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.clear();
+        for (const auto& key : missing)
+        {
+            if (!m_scheduled.count(key))
+                m_requests.push_back(key);
+        }
+    }
+    m_wake.notify_all();
+
+    // Speicherbudget: die am längsten nicht sichtbaren Chunks entfernen. Ist der letzte Chunk
+    // sichtbar, sind es alle (sichtbare Chunks stehen vorne)
+    while (m_cacheBytes > m_settings.memoryBudget && !m_lru.empty() && !isVisible(m_lru.back()))
+    {
+        m_chunks.erase(m_lru.back());
+        m_lru.pop_back();
+        m_cacheBytes -= getChunkBytes();
+    }
+}
+
+void ChunkedTerrain::draw(const glm::mat4& transform, float heightScale)
+{
+    m_program.bind();
+    m_uniformHeightScale.set(heightScale);
+
+    // 2 * viewRadius + 1 Chunks auf [-1, 1] abbilden, relativ zur Kamera (nicht zum Chunk der Kamera),
+    // damit das Terrain gleichmäßig scrollt. Die geladenen Chunks ragen deshalb bis zu einen Chunk über [-1, 1] hinaus
+    const int radius = m_settings.viewRadius;
+    const float chunkSize = m_settings.chunkSize;
+    const float viewScale = 2.0f / (float(2 * radius + 1) * chunkSize);
+    const float halfSize = 0.5f * chunkSize * viewScale;
+
+    for (int z = m_cameraChunk.z - radius; z <= m_cameraChunk.z + radius; ++z)
+    {
+        for (int x = m_cameraChunk.x - radius; x <= m_cameraChunk.x + radius; ++x)
+        {
+            auto it = m_chunks.find({ x, z });
+            // noch nicht geladen
+            if (it == m_chunks.end())
+                continue;
+
+            // Gitter [-1, 1] auf den Chunk abbilden (terrain.vert vertauscht y und z, Gitter-z wird zu y)
+            const vec2 center = ((vec2(float(x), float(z)) + 0.5f) * chunkSize - m_camera) * viewScale;
+            const mat4 model = glm::scale(glm::translate(mat4(1.0f), vec3(center.x, center.y, 0.0f)), vec3(halfSize, halfSize, 1.0f));
+            m_uniformTransform.set(transform * model);
+
+            it->second.vao.drawElements(GL_TRIANGLE_STRIP, m_program, m_indices, true);
+        }
+    }
+}
+
+size_t ChunkedTerrain::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_requests.size() + m_scheduled.size();
+}
+
+void ChunkedTerrain::workerLoop()
+{
+    for (;;)
+    {
+        ChunkKey key;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_quit || !m_requests.empty(); });
+            if (m_quit)
+                return;
+
+            // der nächste Chunk liegt hinten
+            key = m_requests.back();
+            m_requests.pop_back();
+            m_scheduled.insert(key);
+        }
+
+        ChunkData data;
+        generate(key, data);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished.push_back(std::move(data));
+    }
+}
+
+void ChunkedTerrain::generate(const ChunkKey& key, ChunkData& data) const
+{
+    const int resolution = m_settings.chunkResolution;
+    const float spacing = m_settings.chunkSize / float(resolution - 1);
+    // auf 8 aufgerundet, damit jeder Wert (auch am Rand) denselben Codepfad im NoiseKernel nimmt
+    const size_t paddedCount = (size_t(resolution) + 7) & ~size_t(7);
+
+    std::vector<float> sampleX(paddedCount);
+    std::vector<float> sampleZ(paddedCount);
+    std::vector<float> noise(paddedCount);
+    std::vector<float> total(paddedCount);
+
+    data.key = key;
+    data.heights.resize(size_t(resolution) * size_t(resolution));
+
+    float maxAmplitude = 0.0f;
+    float amplitude = 1.0f;
+    for (int i = 0; i < m_settings.octaves; ++i)
+    {
+        maxAmplitude += amplitude;
+        amplitude *= OCTAVE_AMPLITUDE;
+    }
+
+    for (int z = 0; z < resolution; ++z)
+    {
+        // globale Sample-Indizes, damit benachbarte Chunks am Rand dieselben Koordinaten berechnen
+        const float perlinZ = float(key.z * (resolution - 1) + z) * spacing;
+
+        // Oktaven wie in Terrain::generateRows
+        std::fill(total.begin(), total.end(), 0.0f);
+        float frequency = 1.0f;
+        amplitude = 1.0f;
+        for (int i = 0; i < m_settings.octaves; ++i)
+        {
+            for (size_t x = 0; x < paddedCount; ++x)
+            {
+                const float perlinX = float(key.x * (resolution - 1) + int(x)) * spacing;
+                sampleX[x] = perlinX * frequency;
+                sampleZ[x] = perlinZ * frequency;
+            }
+
+            m_noise.evaluate(sampleX.data(), sampleZ.data(), noise.data(), paddedCount);
+
+            for (size_t x = 0; x < paddedCount; ++x)
+                total[x] += noise[x] * amplitude;
+
+            frequency *= OCTAVE_FREQUENCY;
+            amplitude *= OCTAVE_AMPLITUDE;
+        }
+
+        // auf [0, MAX_TERRAIN_HEIGHT] quantisieren
+        GLushort* row = data.heights.data() + size_t(z) * size_t(resolution);
+        for (int x = 0; x < resolution; ++x)
+        {
+            const float height = (total[x] / maxAmplitude) * 0.5f * 1.2f;
+            const long quantized = std::lround(height / MAX_TERRAIN_HEIGHT * 65535.0f);
+            row[x] = GLushort(std::max(0L, std::min(quantized, 65535L)));
+        }
+    }
+}
+
+void ChunkedTerrain::upload(ChunkData& data)
+{
+    Chunk& chunk = m_chunks[data.key];
+    for (GLushort height : data.heights)
+        chunk.heights.addVertex(height);
+    chunk.heights.uploadToGpu();
+    chunk.vao.attachBuffer(1, chunk.heights);
+
+    m_lru.push_front(data.key);
+    chunk.lru = m_lru.begin();
+    m_cacheBytes += getChunkBytes();
+}
+
+ChunkedTerrain::ChunkKey ChunkedTerrain::getChunkKey(const glm::vec2& position) const
+{
+    return { int(std::floor(position.x / m_settings.chunkSize)), int(std::floor(position.y / m_settings.chunkSize)) };
+}
+
+int ChunkedTerrain::distance2(const ChunkKey& a, const ChunkKey& b)
+{
+    const int dx = a.x - b.x;
+    const int dz = a.z - b.z;
+    return dx * dx + dz * dz;
+}
+
+size_t ChunkedTerrain::getChunkBytes() const
+{
+    // Höhen auf der GPU und die CPU-Kopie im VertexBuffer
+    return 2 * size_t(m_settings.chunkResolution) * size_t(m_settings.chunkResolution) * sizeof(GLushort);
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "../framework/VertexArrayObject.h"
+#include "../framework/Uniform.h"
+#include "../framework/VertexBuffer.h"
+#include "../framework/IndexBuffer.h"
+#include "../framework/Program.h"
+#include "NoiseKernel.h"
+
+/// \brief unendliches Terrain aus quadratischen Chunks um die Kamera.
+/// Die Chunks werden auf eigenen Threads mit derselben Rauschfunktion wie Terrain erzeugt und
+/// teilen sich die Randvertices exakt. Fertige Chunks werden pro Frame höchstens bis zum
+/// Upload-Budget hochgeladen und liegen in einem LRU-Cache mit Speicherbudget.
+/// update() und draw() warten nie auf die Erzeugung
+class ChunkedTerrain
+{
+public:
+	struct Settings
+	{
+		// Vertices pro Chunk-Seite (die Randvertices gehören zu beiden Nachbarn)
+		int chunkResolution = 65;
+		// Kantenlänge eines Chunks in Perlin-Koordinaten
+		float chunkSize = 2.0f;
+		int octaves = 4;
+		// sichtbare Chunks in jede Richtung um den Chunk der Kamera
+		int viewRadius = 4;
+		// GPU-Speicher aller Chunks im Cache in Bytes (sichtbare Chunks werden nie entfernt)
+		size_t memoryBudget = size_t(16) << 20;
+		// höchstens so viele Chunks werden pro Frame hochgeladen
+		int uploadsPerFrame = 4;
+		// Threads für die Erzeugung (0 = alle Kerne außer dem Hauptthread)
+		size_t numThreads = 0;
+	};
+
+	explicit ChunkedTerrain(const Settings& settings);
+	~ChunkedTerrain();
+	ChunkedTerrain(const ChunkedTerrain&) = delete;
+	ChunkedTerrain& operator=(const ChunkedTerrain&) = delete;
+
+	/// \brief lädt fertige Chunks hoch, fordert fehlende an und entfernt alte Chunks aus dem Cache
+	/// \param camera Kameraposition in Perlin-Koordinaten (x, z)
+	void update(const glm::vec2& camera);
+
+	/// \brief zeichnet die geladenen Chunks im Sichtbereich, die Kamera liegt im Ursprung. Ein Bereich von
+	/// 2 * viewRadius + 1 Chunks entspricht [-1, 1]; da die Chunks um den Chunk der Kamera liegen, ragen sie
+	/// auf einer Seite bis zu einen Chunk darüber hinaus
+	/// \param heightScale Höhenskalierung im Shader (siehe Terrain::getRelativeHeightScale)
+	void draw(const glm::mat4& transform, float heightScale);
+
+	/// \return Anzahl der Chunks im Cache
+	size_t getLoadedCount() const { return m_chunks.size(); }
+	/// \return Anzahl der angeforderten, noch nicht hochgeladenen Chunks
+	size_t getPendingCount() const;
+	/// \return GPU-Speicher der Chunks im Cache in Bytes
+	size_t getCacheBytes() const { return m_cacheBytes; }
+
+private:
+	struct ChunkKey
+	{
+		int x;
+		int z;
+		bool operator==(const ChunkKey& o) const { return x == o.x && z == o.z; }
+	};
+
+	struct ChunkKeyHash
+	{
+		size_t operator()(const ChunkKey& k) const { return size_t(uint32_t(k.x)) * 73856093u ^ size_t(uint32_t(k.z)) * 19349663u; }
+	};
+
+	/// \brief Ergebnis eines Workers (noch nicht hochgeladen)
+	struct ChunkData
+	{
+		ChunkKey key;
+		std::vector<GLushort> heights;
+	};
+
+	/// \brief hochgeladener Chunk
+	struct Chunk
+	{
+		VertexBuffer<GLushort> heights;
+		VertexArrayObject vao;
+		// Position im LRU (vorne = zuletzt benutzt)
+		std::list<ChunkKey>::iterator lru;
+	};
+
+	void workerLoop();
+	/// \brief berechnet die Höhen eines Chunks (auf einem Worker)
+	void generate(const ChunkKey& key, ChunkData& data) const;
+	void upload(ChunkData& data);
+	/// \brief Chunk, in dem der Punkt liegt
+	ChunkKey getChunkKey(const glm::vec2& position) const;
+	/// \brief quadratischer Abstand zwischen den Chunks
+	static int distance2(const ChunkKey& a, const ChunkKey& b);
+	size_t getChunkBytes() const;
+
+private:
+	Settings m_settings;
+	NoiseKernel m_noise = NoiseKernel(758385u);
+
+	// Chunks im Cache (nur Hauptthread)
+	std::unordered_map<ChunkKey, Chunk, ChunkKeyHash> m_chunks;
+	std::list<ChunkKey> m_lru;
+	size_t m_cacheBytes = 0;
+	ChunkKey m_cameraChunk = { 0, 0 };
+	glm::vec2 m_camera = glm::vec2(0.0f);
+
+	// von allen Chunks geteilte Gitter-Indizes
+	BasicIndexBuffer<uint16_t> m_indices;
+
+	// Worker (durch m_mutex geschützt)
+	std::vector<std::thread> m_workers;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake;
+	bool m_quit = false;
+	// Anforderungen, der nächste Chunk liegt hinten
+	std::vector<ChunkKey> m_requests;
+	// in Arbeit oder fertig, aber noch nicht hochgeladen
+	std::unordered_set<ChunkKey, ChunkKeyHash> m_scheduled;
+	std::vector<ChunkData> m_finished;
+
+	Program m_program;
+	Uniform<glm::mat4> m_uniformTransform;
+	Uniform<float> m_uniformHeightScale;
+	Uniform<GLint> m_uniformCompact;
+	Uniform<GLint> m_uniformResolution;
+	Uniform<glm::vec2> m_uniformHeightRange;
+};
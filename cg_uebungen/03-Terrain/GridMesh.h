@@ -0,0 +1,24 @@
+#pragma once
+#include "../framework/IndexBuffer.h"
+
+/// \brief füllt und lädt die Indizes eines quadratischen Gitters mit resolution^2 Vertices hoch.
+/// Ein Triangle-Strip pro Zeilenpaar, getrennt durch den Restart-Index (mit Primitive Restart zeichnen).
+/// Die Dreiecke und ihre Orientierung entsprechen zwei Dreiecken (oben links, unten links, oben rechts)
+/// und (oben rechts, unten links, unten rechts) pro Quad
+template<class TIndex>
+void fillGridStrips(BasicIndexBuffer<TIndex>& indices, int resolution)
+{
+	indices.clear();
+	for (int z = 0; z < resolution - 1; ++z)
+	{
+		if (z > 0)
+			indices.addRestart();
+
+		for (int x = 0; x < resolution; ++x)
+		{
+			indices.addIndex(TIndex(z * resolution + x));
+			indices.addIndex(TIndex((z + 1) * resolution + x));
+		}
+	}
+	indices.uploadToGpu();
+}
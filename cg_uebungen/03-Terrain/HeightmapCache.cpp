@@ -0,0 +1,248 @@
+#include "HeightmapCache.h"
+#include "../framework/MappedFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+    // Dateikopf, danach count Höhen und optional count Ableitungen (vec2)
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t format;
+        HeightmapCache::Key key;
+        uint32_t count;
+        uint32_t hasGradient;
+    };
+
+    const char MAGIC[8] = { 'H', 'M', 'C', 'A', 'C', 'H', 'E', '\0' };
+    // Version des Dateiformats (nicht des Generators)
+    const uint32_t FORMAT_VERSION = 1;
+
+    bool createDirectory(const std::string& directory)
+    {
+#ifdef _WIN32
+        return _mkdir(directory.c_str()) == 0 || errno == EEXIST;
+#else
+        return mkdir(directory.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+    }
+}
+
+HeightmapCache::HeightmapCache(const std::string& directory, size_t maxBytes)
+    : m_directory(directory),
+      m_maxBytes(maxBytes)
+{
+    m_writable = createDirectory(m_directory);
+    if (!m_writable)
+        return;
+
+    readIndex();
+    // das Budget könnte kleiner geworden sein
+    evict(0);
+}
+
+HeightmapCache::~HeightmapCache()
+{
+    if (m_indexDirty)
+        writeIndex();
+}
+
+HeightmapCache::HeightmapCache(HeightmapCache&& other) noexcept
+    : m_directory(std::move(other.m_directory)),
+      m_maxBytes(other.m_maxBytes),
+      m_writable(other.m_writable),
+      m_entries(std::move(other.m_entries)),
+      m_useCounter(other.m_useCounter),
+      m_indexDirty(other.m_indexDirty)
+{
+    // nur der neue Cache schreibt den Index
+    other.m_writable = false;
+    other.m_indexDirty = false;
+}
+
+bool HeightmapCache::load(const Key& key, std::vector<float>& heights, std::vector<glm::vec2>* gradient)
+{
+    // nur Dateien aus dem Index (die Größe zählt zum Budget)
+    auto entry = findEntry(getFileName(key));
+    if (entry == m_entries.end())
+        return false;
+
+    MappedFile file;
+    if (!file.open(getPath(entry->name)))
+    {
+        m_entries.erase(entry);
+        writeIndex();
+        return false;
+    }
+
+    // Kopf und Größe prüfen, ungültige Einträge werden gelöscht
+    FileHeader header;
+    bool valid = file.size() >= sizeof(header);
+    if (valid)
+    {
+        memcpy(&header, file.data(), sizeof(header));
+        const size_t count = size_t(key.resolution) * size_t(key.resolution);
+        const size_t bytes = sizeof(header) + count * sizeof(float) + (header.hasGradient ? count * sizeof(glm::vec2) : 0);
+        valid = memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.format == FORMAT_VERSION
+            && memcmp(&header.key, &key, sizeof(key)) == 0 && header.count == count && file.size() == bytes;
+    }
+    if (!valid)
+    {
+        file.close();
+        removeEntry(entry);
+        writeIndex();
+        return false;
+    }
+
+    // gültig, aber ohne die gewünschten Ableitungen
+    if (gradient && !header.hasGradient)
+        return false;
+
+    const uint8_t* data = file.data() + sizeof(header);
+    heights.resize(header.count);
+    memcpy(heights.data(), data, header.count * sizeof(float));
+    if (gradient)
+    {
+        gradient->resize(header.count);
+        memcpy(gradient->data(), data + header.count * sizeof(float), header.count * sizeof(glm::vec2));
+    }
+
+    // nur im Speicher, damit ein Treffer keine Datei schreibt
+    entry->lastUse = ++m_useCounter;
+    m_indexDirty = true;
+    return true;
+}
+
+void HeightmapCache::store(const Key& key, const std::vector<float>& heights, const std::vector<glm::vec2>* gradient)
+{
+    const size_t count = heights.size();
+    const size_t bytes = sizeof(FileHeader) + count * sizeof(float) + (gradient ? count * sizeof(glm::vec2) : 0);
+    if (!m_writable || bytes > m_maxBytes || count != size_t(key.resolution) * size_t(key.resolution))
+        return;
+
+    // ein vorhandener Eintrag wird ersetzt
+    const std::string name = getFileName(key);
+    auto existing = findEntry(name);
+    if (existing != m_entries.end())
+        m_entries.erase(existing);
+    evict(bytes);
+
+    FileHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.format = FORMAT_VERSION;
+    header.key = key;
+    header.count = uint32_t(count);
+    header.hasGradient = gradient ? 1 : 0;
+
+    // in eine temporäre Datei schreiben und umbenennen, damit nie eine halbe Datei gelesen wird
+    const std::string path = getPath(name);
+    const std::string tempPath = path + ".tmp";
+    bool written;
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(heights.data()), std::streamsize(count * sizeof(float)));
+        if (gradient)
+            file.write(reinterpret_cast<const char*>(gradient->data()), std::streamsize(count * sizeof(glm::vec2)));
+        written = bool(file);
+    }
+
+    // rename überschreibt unter Windows keine vorhandene Datei
+    std::remove(path.c_str());
+    if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tempPath.c_str());
+        writeIndex();
+        return;
+    }
+
+    m_entries.push_back({ name, bytes, ++m_useCounter });
+    writeIndex();
+}
+
+size_t HeightmapCache::getBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& entry : m_entries)
+        bytes += entry.bytes;
+    return bytes;
+}
+
+std::string HeightmapCache::getFileName(const Key& key) const
+{
+    // FNV-1a über den Schlüssel (Kollisionen erkennt der Dateikopf)
+    uint64_t hash = 14695981039346656037ull;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&key);
+    for (size_t i = 0; i < sizeof(key); ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    char name[40];
+    snprintf(name, sizeof(name), "heightmap_%016llx.bin", static_cast<unsigned long long>(hash));
+    return name;
+}
+
+std::string HeightmapCache::getPath(const std::string& name) const
+{
+    return m_directory + "/" + name;
+}
+
+std::vector<HeightmapCache::Entry>::iterator HeightmapCache::findEntry(const std::string& name)
+{
+    return std::find_if(m_entries.begin(), m_entries.end(), [&](const Entry& e) { return e.name == name; });
+}
+
+void HeightmapCache::removeEntry(std::vector<Entry>::iterator entry)
+{
+    std::remove(getPath(entry->name).c_str());
+    m_entries.erase(entry);
+}
+
+void HeightmapCache::evict(size_t requiredBytes)
+{
+    bool changed = false;
+    while (!m_entries.empty() && getBytes() + requiredBytes > m_maxBytes)
+    {
+        auto oldest = std::min_element(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+        removeEntry(oldest);
+        changed = true;
+    }
+
+    if (changed)
+        writeIndex();
+}
+
+void HeightmapCache::readIndex()
+{
+    // Zeilen: Dateiname, Größe, letzte Benutzung
+    std::ifstream file(getPath("index.txt"));
+    Entry entry;
+    while (file >> entry.name >> entry.bytes >> entry.lastUse)
+    {
+        m_entries.push_back(entry);
+        m_useCounter = std::max(m_useCounter, entry.lastUse);
+    }
+}
+
+void HeightmapCache::writeIndex()
+{
+    if (!m_writable)
+        return;
+
+    m_indexDirty = false;
+    std::ofstream file(getPath("index.txt"), std::ios::trunc);
+    for (const auto& entry : m_entries)
+        file << entry.name << ' ' << entry.bytes << ' ' << entry.lastUse << '\n';
+}
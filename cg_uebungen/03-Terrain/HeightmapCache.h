@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "../framework/glmmath.h"
+
+/// \brief Cache für erzeugte Heightmaps auf der Festplatte.
+/// Jeder Eintrag ist eine Binärdatei im Cache-Verzeichnis und wird beim Treffer per Memory-Mapping gelesen.
+/// Die Gesamtgröße ist begrenzt, darüber werden die am längsten nicht benutzten Einträge gelöscht
+/// (Reihenfolge in index.txt). Lese- und Schreibfehler zählen als Cache-Miss.
+/// Treffer ändern den Index nur im Speicher, geschrieben wird er beim Speichern, Löschen und im Destruktor
+class HeightmapCache
+{
+public:
+	/// \brief alles, wovon die Heightmap abhängt
+	struct Key
+	{
+		uint32_t seed;
+		int32_t resolution;
+		float perlinRes;
+		int32_t octaves;
+		float persistence;
+		// Version des Generators (erhöhen, wenn sich die erzeugten Höhen ändern)
+		uint32_t version;
+	};
+
+	/// \param directory Cache-Verzeichnis (wird bei Bedarf angelegt)
+	/// \param maxBytes höchste Gesamtgröße aller Einträge in Bytes
+	HeightmapCache(const std::string& directory, size_t maxBytes);
+	/// \brief schreibt den Index, falls sich die Benutzungsreihenfolge geändert hat
+	~HeightmapCache();
+	HeightmapCache(const HeightmapCache&) = delete;
+	HeightmapCache& operator=(const HeightmapCache&) = delete;
+	HeightmapCache(HeightmapCache&& other) noexcept;
+
+	/// \brief liest die Höhen und optional die Ableitungen eines Eintrags
+	/// \param heights wird auf resolution^2 Werte gesetzt
+	/// \param gradient optional (der Eintrag muss dann Ableitungen enthalten)
+	/// \return false bei einem Cache-Miss
+	bool load(const Key& key, std::vector<float>& heights, std::vector<glm::vec2>* gradient);
+
+	/// \brief speichert einen Eintrag (ersetzt einen vorhandenen) und löscht alte Einträge über dem Budget
+	/// \param gradient optional die Ableitungen (gleiche Anzahl wie heights)
+	void store(const Key& key, const std::vector<float>& heights, const std::vector<glm::vec2>* gradient);
+
+	/// \return Gesamtgröße aller Einträge in Bytes
+	size_t getBytes() const;
+
+private:
+	struct Entry
+	{
+		std::string name;
+		size_t bytes;
+		// größer = später benutzt
+		uint64_t lastUse;
+	};
+
+	std::string getFileName(const Key& key) const;
+	std::string getPath(const std::string& name) const;
+	std::vector<Entry>::iterator findEntry(const std::string& name);
+	/// \brief löscht die Datei und den Eintrag
+	void removeEntry(std::vector<Entry>::iterator entry);
+	/// \brief löscht die ältesten Einträge, bis requiredBytes zusätzlich ins Budget passen
+	void evict(size_t requiredBytes);
+	void readIndex();
+	void writeIndex();
+
+private:
+	std::string m_directory;
+	size_t m_maxBytes;
+	// false, wenn das Verzeichnis nicht angelegt werden konnte (dann wird nichts gespeichert)
+	bool m_writable = false;
+	std::vector<Entry> m_entries;
+	uint64_t m_useCounter = 0;
+	// lastUse wurde seit dem letzten Schreiben des Index geändert
+	bool m_indexDirty = false;
+};
@@ -0,0 +1,263 @@
+#include "NoiseKernel.h"
+#include "../framework/error.h"
+#include <cmath>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+NoiseKernel::NoiseKernel(uint32_t seed)
+    : m_seed(seed)
+{
+    // Richtung i entspricht dem Winkel i / DIRECTION_COUNT * 2pi
+    for (uint32_t i = 0; i < DIRECTION_COUNT; ++i)
+    {
+        const double angle = double(i) / double(DIRECTION_COUNT) * 6.28318530717958647692;
+        m_directionX[i] = float(std::cos(angle));
+        m_directionZ[i] = float(std::sin(angle));
+    }
+}
+
+uint32_t NoiseKernel::directionIndex(uint32_t x, uint32_t z) const
+{
+    // pcg3d wie in Pseudorandom
+    uint32_t v0 = x * 1664525u + 1013904223u;
+    uint32_t v1 = z * 1664525u + 1013904223u;
+    uint32_t v2 = m_seed * 1664525u + 1013904223u;
+
+    v0 += v1 * v2;
+    v1 += v2 * v0;
+    v2 += v0 * v1;
+
+    v0 ^= v0 >> 16u;
+    v1 ^= v1 >> 16u;
+    v2 ^= v2 >> 16u;
+
+    v0 += v1 * v2;
+
+    // auf die nächste Tabellenrichtung runden (v0 / 2^32 * DIRECTION_COUNT)
+    return (((v0 >> 19u) + 1u) >> 1u) & (DIRECTION_COUNT - 1u);
+}
+
+float NoiseKernel::evaluate(float x, float z, float* outDx, float* outDz) const
+{
+    float result;
+    evaluate(&x, &z, &result, 1, outDx, outDz);
+    return result;
+}
+
+void NoiseKernel::evaluate(const float* x, const float* z, float* out, size_t count, float* outDx, float* outDz) const
+{
+#ifdef __AVX2__
+    const __m256i mul = _mm256_set1_epi32(1664525);
+    const __m256i add = _mm256_set1_epi32(1013904223);
+    const __m256i seed = _mm256_set1_epi32(int(m_seed * 1664525u + 1013904223u));
+    const __m256i indexMask = _mm256_set1_epi32(DIRECTION_COUNT - 1);
+    const __m256i one = _mm256_set1_epi32(1);
+
+    // Gradientenindex für 8 Gitterpunkte (pcg3d, der dritte Wert ist konstant)
+    auto index8 = [&](__m256i ix, __m256i iz)
+    {
+        __m256i v0 = _mm256_add_epi32(_mm256_mullo_epi32(ix, mul), add);
+        __m256i v1 = _mm256_add_epi32(_mm256_mullo_epi32(iz, mul), add);
+        __m256i v2 = seed;
+
+        v0 = _mm256_add_epi32(v0, _mm256_mullo_epi32(v1, v2));
+        v1 = _mm256_add_epi32(v1, _mm256_mullo_epi32(v2, v0));
+        v2 = _mm256_add_epi32(v2, _mm256_mullo_epi32(v0, v1));
+
+        v0 = _mm256_xor_si256(v0, _mm256_srli_epi32(v0, 16));
+        v1 = _mm256_xor_si256(v1, _mm256_srli_epi32(v1, 16));
+        v2 = _mm256_xor_si256(v2, _mm256_srli_epi32(v2, 16));
+
+        v0 = _mm256_add_epi32(v0, _mm256_mullo_epi32(v1, v2));
+
+        return _mm256_and_si256(_mm256_srli_epi32(_mm256_add_epi32(_mm256_srli_epi32(v0, 19), one), 1), indexMask);
+    };
+#else
+    const int index8 = 0; // nur skalar
+#endif
+
+    dassert((outDx == nullptr) == (outDz == nullptr));
+    evaluateWith(x, z, out, outDx, outDz, count, m_directionX.data(), m_directionZ.data(), index8, [this](uint32_t x, uint32_t z) { return directionIndex(x, z); });
+}
+
+void NoiseKernel::buildLattice(int x0, int z0, int width, int height, Lattice& lattice) const
+{
+    dassert(width > 0 && height > 0);
+    lattice.originX = x0;
+    lattice.originZ = z0;
+    lattice.width = width;
+    lattice.height = height;
+    lattice.directionX.resize(size_t(width) * size_t(height));
+    lattice.directionZ.resize(size_t(width) * size_t(height));
+
+    size_t i = 0;
+    for (int z = 0; z < height; ++z)
+        for (int x = 0; x < width; ++x, ++i)
+        {
+            const uint32_t index = directionIndex(uint32_t(x0 + x), uint32_t(z0 + z));
+            lattice.directionX[i] = m_directionX[index];
+            lattice.directionZ[i] = m_directionZ[index];
+        }
+}
+
+void NoiseKernel::evaluate(const Lattice& lattice, const float* x, const float* z, float* out, size_t count,
+    float* outDx, float* outDz) const
+{
+    const int width = lattice.width;
+
+    auto index1 = [&](uint32_t x, uint32_t z)
+    {
+        const int localX = int(x) - lattice.originX;
+        const int localZ = int(z) - lattice.originZ;
+        dassert(localX >= 0 && localX < lattice.width);
+        dassert(localZ >= 0 && localZ < lattice.height);
+        return uint32_t(localZ * width + localX);
+    };
+
+#ifdef __AVX2__
+    const __m256i origin = _mm256_set1_epi32(lattice.originZ * width + lattice.originX);
+    const __m256i stride = _mm256_set1_epi32(width);
+
+    auto index8 = [&](__m256i ix, __m256i iz)
+    {
+        return _mm256_sub_epi32(_mm256_add_epi32(_mm256_mullo_epi32(iz, stride), ix), origin);
+    };
+#else
+    const int index8 = 0; // nur skalar
+#endif
+
+    dassert((outDx == nullptr) == (outDz == nullptr));
+    evaluateWith(x, z, out, outDx, outDz, count, lattice.directionX.data(), lattice.directionZ.data(), index8, index1);
+}
+
+template<class Index8, class Index1>
+void NoiseKernel::evaluateWith(const float* x, const float* z, float* out, float* outDx, float* outDz, size_t count,
+    const float* directionX, const float* directionZ, const Index8& index8, const Index1& index1) const
+{
+    size_t i = 0;
+
+#ifdef __AVX2__
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 onef = _mm256_set1_ps(1.0f);
+    const __m256 twof = _mm256_set1_ps(2.0f);
+    const __m256 threef = _mm256_set1_ps(3.0f);
+    const __m256 halff = _mm256_set1_ps(0.5f);
+    const __m256 sixf = _mm256_set1_ps(6.0f);
+
+    // Skalarprodukt von Gradient und Abstandsvektor, der Gradient wird für die Ableitungen zurückgegeben
+    auto gradientDot = [&](__m256i index, __m256 dx, __m256 dz, __m256& gx, __m256& gz)
+    {
+        gx = _mm256_i32gather_ps(directionX, index, 4);
+        gz = _mm256_i32gather_ps(directionZ, index, 4);
+        return _mm256_add_ps(_mm256_mul_ps(gx, dx), _mm256_mul_ps(gz, dz));
+    };
+
+    // glm::mix(a, b, t) = a * (1 - t) + b * t
+    auto mix = [&](__m256 a, __m256 b, __m256 t)
+    {
+        return _mm256_add_ps(_mm256_mul_ps(a, _mm256_sub_ps(onef, t)), _mm256_mul_ps(b, t));
+    };
+
+    // t * t * (3 - 2t)
+    auto fade = [&](__m256 t)
+    {
+        return _mm256_mul_ps(_mm256_mul_ps(t, t), _mm256_sub_ps(threef, _mm256_mul_ps(twof, t)));
+    };
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 pz = _mm256_loadu_ps(z + i);
+        const __m256 fx = _mm256_floor_ps(px);
+        const __m256 fz = _mm256_floor_ps(pz);
+
+        const __m256i x0 = _mm256_cvttps_epi32(fx);
+        const __m256i z0 = _mm256_cvttps_epi32(fz);
+        const __m256i x1 = _mm256_add_epi32(x0, one);
+        const __m256i z1 = _mm256_add_epi32(z0, one);
+
+        const __m256 dx = _mm256_sub_ps(px, fx);
+        const __m256 dz = _mm256_sub_ps(pz, fz);
+        const __m256 dx1 = _mm256_sub_ps(dx, onef);
+        const __m256 dz1 = _mm256_sub_ps(dz, onef);
+
+        __m256 gx00, gz00, gx10, gz10, gx01, gz01, gx11, gz11;
+        const __m256 dot00 = gradientDot(index8(x0, z0), dx, dz, gx00, gz00);
+        const __m256 dot10 = gradientDot(index8(x1, z0), dx1, dz, gx10, gz10);
+        const __m256 dot01 = gradientDot(index8(x0, z1), dx, dz1, gx01, gz01);
+        const __m256 dot11 = gradientDot(index8(x1, z1), dx1, dz1, gx11, gz11);
+
+        const __m256 wx = fade(dx);
+        const __m256 wz = fade(dz);
+
+        const __m256 ix0 = mix(dot00, dot10, wx);
+        const __m256 ix1 = mix(dot01, dot11, wx);
+        const __m256 value = mix(ix0, ix1, wz);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(value, halff), halff));
+
+        if (outDx)
+        {
+            // fade'(t) = 6t(1 - t)
+            const __m256 dwx = _mm256_mul_ps(_mm256_mul_ps(sixf, dx), _mm256_sub_ps(onef, dx));
+            const __m256 dwz = _mm256_mul_ps(_mm256_mul_ps(sixf, dz), _mm256_sub_ps(onef, dz));
+
+            const __m256 ix0dx = _mm256_add_ps(mix(gx00, gx10, wx), _mm256_mul_ps(_mm256_sub_ps(dot10, dot00), dwx));
+            const __m256 ix1dx = _mm256_add_ps(mix(gx01, gx11, wx), _mm256_mul_ps(_mm256_sub_ps(dot11, dot01), dwx));
+            const __m256 valueDx = mix(ix0dx, ix1dx, wz);
+            const __m256 valueDz = _mm256_add_ps(mix(mix(gz00, gz10, wx), mix(gz01, gz11, wx), wz), _mm256_mul_ps(_mm256_sub_ps(ix1, ix0), dwz));
+
+            _mm256_storeu_ps(outDx + i, _mm256_mul_ps(valueDx, halff));
+            _mm256_storeu_ps(outDz + i, _mm256_mul_ps(valueDz, halff));
+        }
+    }
+#else
+    (void)index8;
+#endif
+
+    for (; i < count; ++i)
+    {
+        const float fx = std::floor(x[i]);
+        const float fz = std::floor(z[i]);
+        const uint32_t x0 = uint32_t(int(fx));
+        const uint32_t z0 = uint32_t(int(fz));
+
+        const float dx = x[i] - fx;
+        const float dz = z[i] - fz;
+
+        const uint32_t g00 = index1(x0, z0);
+        const uint32_t g10 = index1(x0 + 1, z0);
+        const uint32_t g01 = index1(x0, z0 + 1);
+        const uint32_t g11 = index1(x0 + 1, z0 + 1);
+
+        const float dot00 = directionX[g00] * dx + directionZ[g00] * dz;
+        const float dot10 = directionX[g10] * (dx - 1.0f) + directionZ[g10] * dz;
+        const float dot01 = directionX[g01] * dx + directionZ[g01] * (dz - 1.0f);
+        const float dot11 = directionX[g11] * (dx - 1.0f) + directionZ[g11] * (dz - 1.0f);
+
+        const float wx = dx * dx * (3.0f - 2.0f * dx);
+        const float wz = dz * dz * (3.0f - 2.0f * dz);
+
+        const float ix0 = dot00 * (1.0f - wx) + dot10 * wx;
+        const float ix1 = dot01 * (1.0f - wx) + dot11 * wx;
+        const float value = ix0 * (1.0f - wz) + ix1 * wz;
+
+        out[i] = value * 0.5f + 0.5f;
+
+        if (outDx)
+        {
+            // Produkt- und Kettenregel, fade'(t) = 6t(1 - t)
+            const float dwx = 6.0f * dx * (1.0f - dx);
+            const float dwz = 6.0f * dz * (1.0f - dz);
+
+            const float ix0dx = directionX[g00] * (1.0f - wx) + directionX[g10] * wx + (dot10 - dot00) * dwx;
+            const float ix1dx = directionX[g01] * (1.0f - wx) + directionX[g11] * wx + (dot11 - dot01) * dwx;
+            const float ix0dz = directionZ[g00] * (1.0f - wx) + directionZ[g10] * wx;
+            const float ix1dz = directionZ[g01] * (1.0f - wx) + directionZ[g11] * wx;
+
+            outDx[i] = (ix0dx * (1.0f - wz) + ix1dx * wz) * 0.5f;
+            outDz[i] = (ix0dz * (1.0f - wz) + ix1dz * wz + (ix1 - ix0) * dwz) * 0.5f;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+
+/// \brief Perlin-Noise für viele Samples auf einmal (8 pro Schleifendurchlauf mit AVX2, sonst skalar).
+/// Entspricht Terrain::perlinNoise mit Pseudorandom, nur dass die Gradienten aus einer Tabelle
+/// mit DIRECTION_COUNT Richtungen statt aus cos/sin kommen. Die Abweichung zur trigonometrischen
+/// Version ist kleiner als MAX_ERROR
+class NoiseKernel
+{
+public:
+	/// \brief Anzahl der Gradientenrichtungen (Zweierpotenz)
+	static constexpr uint32_t DIRECTION_COUNT = 4096;
+	/// \brief maximale Abweichung zu cos/sin-Gradienten (Winkelfehler pi/4096 auf Vektoren der Länge <= sqrt(2), halbiert).
+	/// Gemessen wurden höchstens 2.3e-4
+	static constexpr float MAX_ERROR = 5.5e-4f;
+
+	/// \param seed Seed des pcg3d-Hashes (wie bei Pseudorandom)
+	explicit NoiseKernel(uint32_t seed);
+
+	/// \brief berechnet das Rauschen für einen Punkt
+	/// \param outDx, outDz optional die partiellen Ableitungen nach x und z (im selben Durchlauf)
+	/// \return Wert in [0, 1]
+	float evaluate(float x, float z, float* outDx = nullptr, float* outDz = nullptr) const;
+
+	/// \brief berechnet das Rauschen für count Punkte
+	/// \param x x-Koordinaten
+	/// \param z z-Koordinaten
+	/// \param out Ergebnisse in [0, 1] (darf nicht mit x oder z überlappen)
+	/// \param outDx, outDz optional die analytischen partiellen Ableitungen nach x und z. Die Werte in out
+	/// sind dieselben wie ohne Ableitungen
+	void evaluate(const float* x, const float* z, float* out, size_t count, float* outDx = nullptr, float* outDz = nullptr) const;
+
+	/// \brief vorberechnete Gradienten aller Gitterpunkte eines Rechtecks (siehe buildLattice)
+	struct Lattice
+	{
+		int originX = 0;
+		int originZ = 0;
+		int width = 0;
+		int height = 0;
+		// Gradienten zeilenweise
+		std::vector<float> directionX;
+		std::vector<float> directionZ;
+	};
+
+	/// \brief berechnet die Gradienten der Gitterpunkte [x0, x0 + width) x [z0, z0 + height).
+	/// Danach kostet das Hashing nur noch einmal pro Gitterpunkt statt viermal pro Sample
+	void buildLattice(int x0, int z0, int width, int height, Lattice& lattice) const;
+
+	/// \brief wie evaluate(), aber mit den Gradienten aus lattice (gleiches Ergebnis).
+	/// Alle Samples müssen in [originX, originX + width - 1) x [originZ, originZ + height - 1) liegen
+	void evaluate(const Lattice& lattice, const float* x, const float* z, float* out, size_t count,
+		float* outDx = nullptr, float* outDz = nullptr) const;
+
+private:
+	/// \brief Index der Gradientenrichtung des Gitterpunkts (x, z)
+	uint32_t directionIndex(uint32_t x, uint32_t z) const;
+
+	/// \brief gemeinsame Auswertung. index8 liefert die Indizes in die Richtungsarrays für 8 Gitterpunkte
+	/// (nur mit AVX2), index1 für einen Gitterpunkt. Die Ableitungen werden nur berechnet, wenn outDx nicht null ist
+	template<class Index8, class Index1>
+	void evaluateWith(const float* x, const float* z, float* out, float* outDx, float* outDz, size_t count,
+		const float* directionX, const float* directionZ, const Index8& index8, const Index1& index1) const;
+
+private:
+	uint32_t m_seed;
+
+	// Richtungstabelle getrennt nach Komponenten (für gather)
+	std::array<float, DIRECTION_COUNT> m_directionX;
+	std::array<float, DIRECTION_COUNT> m_directionZ;
+};
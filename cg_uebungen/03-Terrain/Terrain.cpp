@@ -1,16 +1,27 @@
 #include "Terrain.h"
-#include "Pseudorandom.h"
+#include "../framework/Timer.h"
+#include "GridMesh.h"
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 using namespace glm;
 
-Terrain::Terrain(int resolution, float perlinRes, int octaves, float persistence, float heightScale)
+// packt eine Normale wie glm::packSnorm3x10_1x2 (w = 0)
+static PackedSnorm3x10_1x2 packNormal(const vec3& normal)
+{
+    auto component = [](float v) { return GLuint(int(std::lround(glm::clamp(v, -1.0f, 1.0f) * 511.0f)) & 0x3FF); };
+    return { component(normal.x) | component(normal.y) << 10 | component(normal.z) << 20 };
+}
+
+Terrain::Terrain(int resolution, float perlinRes, int octaves, float persistence, float heightScale, size_t numThreads)
     : m_resolution(resolution),
       m_perlinRes(perlinRes),
       m_octaves(octaves),
       m_persistence(persistence),
-      m_heightScale(heightScale)
+      m_heightScale(heightScale),
+      m_initialHeightScale(heightScale),
+      m_threadPool(std::make_unique<ThreadPool>(numThreads))
 {
     regenerate();
 
@@ -21,14 +32,47 @@ Terrain::Terrain(int resolution, float perlinRes, int octaves, float persistence
 
     // Uniform-Variable im Shader suchen und speichern
     m_uniformTransform = m_program.getUniform<glm::mat4>("u_transform", glm::mat4(1.0f));
+    m_uniformHeightScale = m_program.getUniform<float>("u_heightScale", 1.0f);
+    m_uniformCompact = m_program.getUniform<GLint>("u_compact", 0);
+    m_uniformResolution = m_program.getUniform<GLint>("u_resolution", 0);
+    m_uniformHeightRange = m_program.getUniform<glm::vec2>("u_heightRange", glm::vec2(0.0f));
+    m_uniformLit = m_program.getUniform<GLint>("u_lit", 0);
 }
 
 void Terrain::regenerate()
 {
-    // Initialisieren und Terrain regenerieren
-    m_height.assign(m_resolution * m_resolution, 0.0f);
+    // Alle Oktaven und den Vertex-Buffer neu berechnen (die Indizes kommen aus dem Cache)
+    m_validLayers = 0;
+    m_height.resize(m_resolution * m_resolution);
+    m_heightGradient.resize(m_resolution * m_resolution);
 
-    generate();
+    updateHeights();
+    createIndexBuffer();
+}
+
+void Terrain::updateHeights()
+{
+    // im beleuchteten Modus brauchen alle Oktaven ihre Ableitungen
+    if (m_lit && !m_layerDerivatives)
+        m_validLayers = 0;
+    const bool newLayers = m_validLayers < m_octaves;
+    std::vector<vec2>* gradient = m_lit ? &m_heightGradient : nullptr;
+
+    Timer timer;
+    timer.start();
+    // ohne gültige Oktaven zuerst im Cache auf der Festplatte nachsehen. Die Oktaven-Layer sind dann
+    // weiterhin ungültig, die nächste Änderung berechnet also alle Oktaven (oder trifft wieder den Cache)
+    m_heightsFromCache = m_validLayers == 0 && m_heightCache.load(getCacheKey(), m_height, gradient);
+    if (!m_heightsFromCache)
+        generate(m_validLayers);
+    m_generateTime = timer.stop();
+
+    if (!m_heightsFromCache)
+    {
+        if (newLayers)
+            m_layerDerivatives = m_lit;
+        m_heightCache.store(getCacheKey(), m_height, gradient);
+    }
 
     createVertexBuffer();
 }
@@ -41,15 +85,38 @@ void Terrain::draw(const glm::mat4& transform)
     // Transformationsmatrix an den Shader übergeben
     m_uniformTransform.set(transform);
 
+    // Höhenskalierung relativ zum Startwert (die Buffer enthalten die unskalierten Höhen)
+    m_uniformHeightScale.set(getRelativeHeightScale());
+
+    // Gitter und Höhenbereich für die kompakten Vertices
+    m_uniformCompact.set(m_compactVertices ? 1 : 0);
+    m_uniformResolution.set(m_resolution);
+    m_uniformHeightRange.set(m_heightRange);
+    m_uniformLit.set(m_lit ? 1 : 0);
+
     // Terrain malen
-    m_vao.drawElements(GL_TRIANGLES, m_program, m_indices);
+    const GridIndices& grid = m_gridIndices.at(m_resolution);
+    if (grid.use16Bit)
+        m_vao.drawElements(GL_TRIANGLE_STRIP, m_program, grid.indices16, true);
+    else
+        m_vao.drawElements(GL_TRIANGLE_STRIP, m_program, grid.indices32, true);
 }
 
 void Terrain::createVertexBuffer()
 {
-    // Beide Buffer müssen bei jedem Aufruf geleert werden
+    createNormalBuffer();
+
+    if (m_compactVertices)
+    {
+        createCompactVertexBuffer();
+        return;
+    }
+
+    // Buffer des anderen Modus freigeben
+    m_compactHeights = VertexBuffer<GLushort>();
+
+    // Buffer muss bei jedem Aufruf geleert werden
     m_positions.clear();
-    m_indices.clear();
 
     int resolution = m_resolution;
     float maxCoord = static_cast<float>(resolution - 1);
@@ -59,139 +126,270 @@ void Terrain::createVertexBuffer()
     {
         for (int x = 0; x < resolution; ++x)
         {
-            float height = getHeight(x, z); // Höhe an der Position (x, z)
-
             // Skalierung und Verschiebung in den Bereich [-0.5, +0.5]
             float xPos = ((static_cast<float>(x) / maxCoord) - 0.5f) * 2.0f;
             float zPos = ((static_cast<float>(z) / maxCoord) - 0.5f) * 2.0f;
-            float yPos = height / m_heightScale;
+            float yPos = m_height[calcIndex(x, z)]; // Höhe an der Position (x, z), Skalierung im Shader
 
             glm::vec3 position = glm::vec3(xPos, yPos, zPos);
             m_positions.addVertex(position);
         }
     }
 
-    // Indizes für die Dreiecke hinzufügen
-    for (int z = 0; z < resolution - 1; ++z)
-    {
-        for (int x = 0; x < resolution - 1; ++x)
-        {
-            // Vier Eckpunkte des aktuellen Gitters
-            int topLeft = calcIndex(x, z);
-            int topRight = calcIndex(x + 1, z);
-            int bottomLeft = calcIndex(x, z + 1);
-            int bottomRight = calcIndex(x + 1, z + 1);
-
-            // Erstes Dreieck
-            m_indices.addIndex(topLeft);
-            m_indices.addIndex(bottomLeft);
-            m_indices.addIndex(topRight);
-
-            // Zweites Dreieck
-            m_indices.addIndex(topRight);
-            m_indices.addIndex(bottomLeft);
-            m_indices.addIndex(bottomRight);
-        }
-    }
-
     // Daten zur GPU hochladen
     m_positions.uploadToGpu();
-    m_indices.uploadToGpu();
 
     // Vertex-Buffer an VAO anhängen (an Location 0)
     m_vao.attachBuffer(0, m_positions);
+    m_vao.detachBuffer(1);
 }
 
-float Terrain::perlinOctaves(float x, float z) {
-    float total = 0.0f;
-    float maxAmplitude = 0.0f;
-
-    float frequency = 1.0f;
-    float amplitude = 1.0f;
-
-    for (int i = 0; i < m_octaves; ++i) {
-        total += perlinNoise(x * frequency, z * frequency) * amplitude;
-        maxAmplitude += amplitude;
+void Terrain::createCompactVertexBuffer()
+{
+    // Buffer des anderen Modus freigeben
+    m_positions = VertexBuffer<glm::vec3>();
 
-        frequency *= 1.8f; // Frequenz moderat steigern (statt 2.0f)
-        amplitude *= 0.3f; // Kleinere Amplitudenreduzierung (statt direkt mit persistence multiplizieren)
+    // Höhen auf [0, 65535] normalisieren (Fehler höchstens eine halbe Schrittweite)
+    const auto range = std::minmax_element(m_height.begin(), m_height.end());
+    const float minHeight = *range.first;
+    const float step = (*range.second - minHeight) / 65535.0f;
+    m_heightRange = glm::vec2(minHeight, step);
 
+    m_compactHeights.clear();
+    for (float height : m_height)
+    {
+        const float normalized = step > 0.0f ? (height - minHeight) / step : 0.0f;
+        m_compactHeights.addVertex(GLushort(std::min(std::lround(normalized), 65535L)));
     }
 
+    // Daten zur GPU hochladen, x und z berechnet der Shader aus gl_VertexID
+    m_compactHeights.uploadToGpu();
+    m_vao.attachBuffer(1, m_compactHeights);
+    m_vao.detachBuffer(0);
+}
 
-    // Normalisieren des Ergebnisses
-    return (total / maxAmplitude) * 0.5f; // Für kleinere Höhen
+void Terrain::setCompactVertices(bool compact)
+{
+    if (compact == m_compactVertices)
+        return;
 
+    m_compactVertices = compact;
+    createVertexBuffer();
 }
 
+void Terrain::createNormalBuffer()
+{
+    if (!m_lit)
+    {
+        // Buffer freigeben, der Shader liest den konstanten Standardwert
+        m_normals = VertexBuffer<PackedSnorm3x10_1x2>();
+        m_vao.detachBuffer(2);
+        return;
+    }
 
+    // Normale der Fläche y = h(x, z) ist (-dh/dx, 1, -dh/dz). Die Höhenskalierung wendet der Shader an
+    m_normals.clear();
+    for (const vec2& gradient : m_heightGradient)
+    {
+        m_normals.addVertex(packNormal(glm::normalize(vec3(-gradient.x, 1.0f, -gradient.y))));
+    }
 
-void Terrain::generate() {
-    for (int z = 0; z < m_resolution; ++z) {
-        for (int x = 0; x < m_resolution; ++x) {
-            // Umrechnung der Gitterkoordinaten auf die Perlin-Noise-Resolution
-            float perlinX = (static_cast<float>(x) / (m_resolution - 1)) * (m_perlinRes * 0.9f);
-            float perlinZ = (static_cast<float>(z) / (m_resolution - 1)) * (m_perlinRes * 0.9f);
-
+    m_normals.uploadToGpu();
+    m_vao.attachBuffer(2, m_normals);
+}
 
+void Terrain::setLit(bool lit)
+{
+    if (lit == m_lit)
+        return;
 
+    m_lit = lit;
+    // beim Einschalten fehlen die Ableitungen der Höhen (und eventuell der Oktaven)
+    if (m_lit)
+        updateHeights();
+    else
+        createNormalBuffer();
+}
 
-            // Berechnung des Höhenwerts mit Perlin Noise und mehreren Oktaven
-            float height = perlinOctaves(perlinX, perlinZ) * 1.2f; // Leichte Verstärkung des Höhenwertes
-            setHeight(x, z, height);
+void Terrain::createIndexBuffer()
+{
+    if (m_gridIndices.count(m_resolution))
+        return;
 
+    GridIndices& grid = m_gridIndices[m_resolution];
+    const size_t vertexCount = size_t(m_resolution) * size_t(m_resolution);
+    // der größte Vertex-Index (vertexCount - 1) darf nicht der Restart-Index sein
+    grid.use16Bit = vertexCount <= BasicIndexBuffer<uint16_t>::RESTART_INDEX;
 
-        }
-    }
+    if (grid.use16Bit)
+        fillGridStrips(grid.indices16, m_resolution);
+    else
+        fillGridStrips(grid.indices32, m_resolution);
 }
 
+float Terrain::perlinOctaves(float x, float z, glm::vec2* derivative) const {
+    float total = 0.0f;
+    vec2 totalDerivative = vec2(0.0f);
+    float maxAmplitude = 0.0f;
+
+    float frequency = 1.0f;
+    float amplitude = 1.0f;
 
+    for (int i = 0; i < m_octaves; ++i) {
+        vec2 noiseDerivative;
+        total += perlinNoise(x * frequency, z * frequency, derivative ? &noiseDerivative : nullptr) * amplitude;
+        // Kettenregel: d/dx noise(x * frequency) = frequency * noise'
+        if (derivative)
+            totalDerivative += noiseDerivative * (amplitude * frequency);
+        maxAmplitude += amplitude;
 
+        frequency *= OCTAVE_FREQUENCY; // Frequenz moderat steigern (statt 2.0f)
+        amplitude *= OCTAVE_AMPLITUDE; // Kleinere Amplitudenreduzierung (statt direkt mit persistence multiplizieren)
 
+    }
 
-float Terrain::perlinNoise(float x, float z) {
-    // Diese Methode bleibt erhalten, die zweite wird entfernt
-    Pseudorandom rng(758385u);
 
-    int x0 = static_cast<int>(std::floor(x));
-    int x1 = x0 + 1;
-    int z0 = static_cast<int>(std::floor(z));
-    int z1 = z0 + 1;
+    // Normalisieren des Ergebnisses
+    if (derivative)
+        *derivative = totalDerivative / maxAmplitude * 0.5f;
+    return (total / maxAmplitude) * 0.5f; // Für kleinere Höhen
 
-    float dx = x - x0;
-    float dz = z - z0;
+}
 
-    glm::vec2 gradient00 = rng.getRandomDirection(x0, z0);
-    glm::vec2 gradient10 = rng.getRandomDirection(x1, z0);
-    glm::vec2 gradient01 = rng.getRandomDirection(x0, z1);
-    glm::vec2 gradient11 = rng.getRandomDirection(x1, z1);
 
-    glm::vec2 dist00(dx, dz);
-    glm::vec2 dist10(dx - 1, dz);
-    glm::vec2 dist01(dx, dz - 1);
-    glm::vec2 dist11(dx - 1, dz - 1);
 
-    float dot00 = glm::dot(gradient00, dist00);
-    float dot10 = glm::dot(gradient10, dist10);
-    float dot01 = glm::dot(gradient01, dist01);
-    float dot11 = glm::dot(gradient11, dist11);
+void Terrain::generate(int firstOctave) {
+    // Oktaven-Layer anlegen (bereits berechnete Layer bleiben erhalten)
+    const size_t sampleCount = size_t(m_resolution) * size_t(m_resolution);
+    if (m_layers.size() < size_t(m_octaves))
+        m_layers.resize(m_octaves);
+    for (int i = firstOctave; i < m_octaves; ++i) {
+        m_layers[i].value.resize(sampleCount);
+        // Ableitungen nur im beleuchteten Modus
+        m_layers[i].derivativeX.resize(m_lit ? sampleCount : 0);
+        m_layers[i].derivativeZ.resize(m_lit ? sampleCount : 0);
+    }
 
-    auto fade = [](float t) { return t * t * (3.0f - 2.0f * t); }; // Weniger aggressive Glättung
+    buildLattices(firstOctave);
 
+    // Jede Zeile hängt nur von ihren eigenen Koordinaten ab, daher ist das Ergebnis
+    // unabhängig von der Aufteilung auf die Threads
+    m_threadPool->parallelFor(m_resolution, s_generateChunkRows, [this, firstOctave](size_t, size_t first, size_t last)
+        {
+            generateRows(int(first), int(last), firstOctave);
+        });
 
-    float wx = fade(dx);
-    float wz = fade(dz);
+    m_validLayers = std::max(m_validLayers, m_octaves);
+}
 
-    float ix0 = glm::mix(dot00, dot10, wx);
-    float ix1 = glm::mix(dot01, dot11, wx);
-    float value = glm::mix(ix0, ix1, wz);
+void Terrain::buildLattices(int firstOctave) {
+    if (m_lattices.size() < size_t(m_octaves))
+        m_lattices.resize(m_octaves);
+    const size_t sampleCount = size_t(m_resolution) * size_t(m_resolution);
 
-    return value * 0.5f + 0.5f;
+    m_threadPool->parallelFor(std::max(m_octaves - firstOctave, 0), 1, [this, sampleCount, firstOctave](size_t, size_t first, size_t last)
+        {
+            for (size_t i = firstOctave + first; i < firstOctave + last; ++i) {
+                // Frequenz und größte Koordinate (x = m_resolution - 1) wie in generateRows
+                float frequency = 1.0f;
+                for (size_t j = 0; j < i; ++j)
+                    frequency *= OCTAVE_FREQUENCY;
+                float maxCoord = (1.0f * (m_perlinRes * 0.9f)) * frequency;
+
+                // Gitterpunkte [0, floor(maxCoord) + 1] in beide Richtungen
+                int size = static_cast<int>(std::floor(maxCoord)) + 2;
+                if (size_t(size) * size_t(size) <= sampleCount)
+                    m_noise.buildLattice(0, 0, size, size, m_lattices[i]);
+                else
+                    m_lattices[i].directionX.clear(); // mehr Gitterpunkte als Samples, direkt hashen
+            }
+        });
 }
 
+void Terrain::generateRows(int firstZ, int lastZ, int firstOctave) {
+    // Zeilenpuffer für das gebündelte Rauschen (pro Aufruf, damit die Threads getrennte Puffer haben)
+    std::vector<float> sampleX(m_resolution);
+    std::vector<float> sampleZ(m_resolution);
+    std::vector<float> total(m_resolution);
+    std::vector<vec2> totalDerivative(m_resolution);
+    // Ableitung der Perlin-Koordinaten nach den Gitter-Koordinaten [-1, 1]
+    const float perlinPerGrid = (m_perlinRes * 0.9f) * 0.5f;
+
+    float firstFrequency = 1.0f;
+    for (int i = 0; i < firstOctave; ++i)
+        firstFrequency *= OCTAVE_FREQUENCY;
+
+    for (int z = firstZ; z < lastZ; ++z) {
+        // Umrechnung der Gitterkoordinaten auf die Perlin-Noise-Resolution
+        float perlinZ = (static_cast<float>(z) / (m_resolution - 1)) * (m_perlinRes * 0.9f);
+        const size_t row = size_t(z) * size_t(m_resolution);
+
+        // neue Oktaven für die ganze Zeile auf einmal berechnen
+        float frequency = firstFrequency;
+        for (int i = firstOctave; i < m_octaves; ++i) {
+            for (int x = 0; x < m_resolution; ++x) {
+                float perlinX = (static_cast<float>(x) / (m_resolution - 1)) * (m_perlinRes * 0.9f);
+                sampleX[x] = perlinX * frequency;
+                sampleZ[x] = perlinZ * frequency;
+            }
+
+            // Wert und Ableitungen im selben Durchlauf
+            float* noise = m_layers[i].value.data() + row;
+            float* noiseDx = m_lit ? m_layers[i].derivativeX.data() + row : nullptr;
+            float* noiseDz = m_lit ? m_layers[i].derivativeZ.data() + row : nullptr;
+            if (m_lattices[i].directionX.empty())
+                m_noise.evaluate(sampleX.data(), sampleZ.data(), noise, sampleX.size(), noiseDx, noiseDz);
+            else
+                m_noise.evaluate(m_lattices[i], sampleX.data(), sampleZ.data(), noise, sampleX.size(), noiseDx, noiseDz);
+
+            frequency *= OCTAVE_FREQUENCY;
+        }
 
+        // Oktaven wie in perlinOctaves gewichtet aufsummieren
+        std::fill(total.begin(), total.end(), 0.0f);
+        std::fill(totalDerivative.begin(), totalDerivative.end(), vec2(0.0f));
+        float maxAmplitude = 0.0f;
+        float amplitude = 1.0f;
+        frequency = 1.0f;
+
+        for (int i = 0; i < m_octaves; ++i) {
+            const float* noise = m_layers[i].value.data() + row;
+            for (int x = 0; x < m_resolution; ++x)
+                total[x] += noise[x] * amplitude;
+
+            if (m_lit) {
+                // Kettenregel wie in perlinOctaves
+                const float* noiseDx = m_layers[i].derivativeX.data() + row;
+                const float* noiseDz = m_layers[i].derivativeZ.data() + row;
+                for (int x = 0; x < m_resolution; ++x)
+                    totalDerivative[x] += vec2(noiseDx[x], noiseDz[x]) * (amplitude * frequency);
+            }
+            maxAmplitude += amplitude;
+
+            frequency *= OCTAVE_FREQUENCY;
+            amplitude *= OCTAVE_AMPLITUDE;
+        }
 
+        for (int x = 0; x < m_resolution; ++x) {
+            // Berechnung des Höhenwerts mit Perlin Noise und mehreren Oktaven
+            m_height[row + x] = (total[x] / maxAmplitude) * 0.5f * 1.2f; // Leichte Verstärkung des Höhenwertes
+            if (m_lit)
+                m_heightGradient[row + x] = totalDerivative[x] * (0.5f * 1.2f * perlinPerGrid / maxAmplitude);
+        }
+    }
+}
 
+float Terrain::perlinNoise(float x, float z, glm::vec2* derivative) const {
+    // Gradienten aus der Richtungstabelle des Kernels (siehe NoiseKernel::MAX_ERROR)
+    if (derivative)
+        return m_noise.evaluate(x, z, &derivative->x, &derivative->y);
+    return m_noise.evaluate(x, z);
+}
+
+HeightmapCache::Key Terrain::getCacheKey() const
+{
+    return { TERRAIN_SEED, m_resolution, m_perlinRes, m_octaves, m_persistence, GENERATOR_VERSION };
+}
 
 void Terrain::handleUI(Window::Key key, bool useWASD)
 {
@@ -249,28 +447,52 @@ void Terrain::switchOptions(bool increase)
 
 void Terrain::changeOptionValue(bool increase)
 {
+    // Es wird nur neu berechnet, was von der Option abhängt
     switch (m_selectedOption)
     {
     case 0: // Height Scale
+        // nur das Uniform in draw()
         m_heightScale += increase ? STEP_HEIGHT_SCALE : -STEP_HEIGHT_SCALE;
         m_heightScale = std::max(std::min(m_heightScale, 500.f), 1.f);
         break;
     case 1: // Grid Res
+    {
+        const int oldResolution = m_resolution;
         if (increase)
             m_resolution = m_resolution * 2;
         else
             m_resolution = m_resolution / 2;
         m_resolution = std::max(std::min(m_resolution, 256), 4); // Grid Auflösung ist begrenzt zwischen [4,256]
+        // alle Oktaven und der Vertex-Buffer (Index-Buffer pro Auflösung im Cache)
+        if (m_resolution != oldResolution)
+            regenerate();
         break;
+    }
     case 2: // Perlin Res
+    {
+        const float oldPerlinRes = m_perlinRes;
         m_perlinRes += increase ? STEP_PERLIN_RES : -STEP_PERLIN_RES;
         m_perlinRes = std::max(std::min(m_perlinRes, 512.f), 1.f + STEP_PERLIN_RES);
+        // alle Oktaven und der Vertex-Buffer
+        if (m_perlinRes != oldPerlinRes)
+        {
+            m_validLayers = 0;
+            updateHeights();
+        }
         break;
+    }
     case 3: // Octaves
+    {
+        const int oldOctaves = m_octaves;
         m_octaves += increase ? 1 : -1;
         m_octaves = std::min(std::max(1, m_octaves), 16);
+        // nur fehlende Oktaven (entfernte bleiben gespeichert), dann Summe und Vertex-Buffer
+        if (m_octaves != oldOctaves)
+            updateHeights();
         break;
+    }
     case 4: // Persistence
+        // die Amplituden der Oktaven sind fest (siehe perlinOctaves), die Höhen ändern sich nicht
         m_persistence += increase ? STEP_PERSISTENCE : -STEP_PERSISTENCE;
         m_persistence = std::max(std::min(m_persistence, 1.f), STEP_PERSISTENCE);
         break;
@@ -278,7 +500,6 @@ void Terrain::changeOptionValue(bool increase)
         break;
     }
 
-    regenerate();
     outOptionString(); // Update String
 }
 
@@ -291,7 +512,9 @@ void Terrain::outOptionString()
         std::cout << "Height Scale: " + std::to_string(m_heightScale);
         break;
     case 1: // Grid Res
-        std::cout << "Grid Resolution: " + std::to_string(m_resolution);
+        std::cout << "Grid Resolution: " + std::to_string(m_resolution)
+            + " (" + std::to_string(m_generateTime) + " ms, "
+            + (m_heightsFromCache ? std::string("Cache") : std::to_string(m_threadPool->getThreadCount()) + " Threads") + ")";
         break;
     case 2: // Perlin Res
         std::cout << "Perlin Resolution: " + std::to_string(m_perlinRes);
@@ -308,16 +531,9 @@ void Terrain::outOptionString()
     }
 }
 
-void Terrain::setHeight(int x, int z, float height)
-{
-    if (getHeight(x, z) == 0.0f)
-        m_height[calcIndex(x, z)] = height * m_heightScale;
-
-}
-
 float Terrain::getHeight(int x, int z) const
 {
-    return m_height[calcIndex(x, z)];
+    return m_height[calcIndex(x, z)] * m_heightScale;
 }
 
 int Terrain::calcIndex(int x, int z) const
@@ -330,6 +546,11 @@ int Terrain::calcIndex(int x, int z) const
     return z * m_resolution + x;
 }
 
+void Terrain::setThreadCount(size_t numThreads)
+{
+    m_threadPool = std::make_unique<ThreadPool>(numThreads);
+}
+
 glm::mat4 Terrain::getBackupTransformation() const
 {
     return mat4(
@@ -7,33 +7,88 @@
 #include "../framework/VertexBuffer.h"
 #include "../framework/IndexBuffer.h"
 #include "../framework/Program.h"
+#include "../framework/ThreadPool.h"
+#include "NoiseKernel.h"
+#include "HeightmapCache.h"
+#include <memory>
+#include <map>
 
 constexpr int NUM_OPTIONS = 5;
 constexpr float STEP_PERLIN_RES = 0.25f;
 constexpr float STEP_HEIGHT_SCALE = 0.5f;
 constexpr float STEP_PERSISTENCE = 0.01f;
 
+// Faktoren von Frequenz und Amplitude von Oktave zu Oktave
+constexpr float OCTAVE_FREQUENCY = 1.8f;
+constexpr float OCTAVE_AMPLITUDE = 0.3f;
+// größte Höhe (normalisierte Oktavensumme * 0.5 * 1.2)
+constexpr float MAX_TERRAIN_HEIGHT = 0.6f;
+
+// Seed des Perlin-Noise
+constexpr uint32_t TERRAIN_SEED = 758385u;
+// Heightmap-Cache auf der Festplatte (Verzeichnis relativ zum Arbeitsverzeichnis und Größe)
+constexpr const char* HEIGHTMAP_CACHE_DIRECTORY = "heightmap_cache";
+constexpr size_t HEIGHTMAP_CACHE_BYTES = size_t(64) << 20;
+// Version des Generators im Cache-Schlüssel: erhöhen, wenn sich die erzeugten Höhen ändern
+constexpr uint32_t GENERATOR_VERSION = 1;
+
 class Terrain
 {
 public:
-	Terrain(int resolution, float perlinRes, int octaves, float persistence, float heightScale);
+	/// \param numThreads threads for the heightmap generation (0 = hardware concurrency)
+	Terrain(int resolution, float perlinRes, int octaves, float persistence, float heightScale, size_t numThreads = 0);
 
 	void draw(const glm::mat4& transform);
 
 	void handleUI(Window::Key key, bool useWASD = false);
 	void outOptionString();
-	float perlinOctaves(float x, float z);
+	/// \param derivative optional die partiellen Ableitungen nach x und z (analytisch, im selben Durchlauf)
+	float perlinOctaves(float x, float z, glm::vec2* derivative = nullptr) const;
 	float getHeight(int x, int z) const;
 	int getResolution() const;
 	glm::mat4 getBackupTransformation() const;
 
+	/// \brief sets the number of threads for the heightmap generation (0 = hardware concurrency).
+	/// The heightmap does not depend on the thread count
+	void setThreadCount(size_t numThreads);
+
+	/// \brief switches between compact vertices (normalized 16 bit heights only, x and z are computed from
+	/// gl_VertexID in the shader) and full vec3 positions
+	void setCompactVertices(bool compact);
+	bool getCompactVertices() const { return m_compactVertices; }
+
+	/// \brief switches between the white wireframe and diffuse lighting with per-vertex normals.
+	/// The normals come from the analytic noise derivatives, which are only computed (in the same pass
+	/// as the heights) while the terrain is lit
+	void setLit(bool lit);
+	bool getLit() const { return m_lit; }
+
+	/// \return Höhenskalierung relativ zum Start (Faktor im Shader, die Startskalierung entspricht 1)
+	float getRelativeHeightScale() const { return m_heightScale / m_initialHeightScale; }
+	float getPerlinResolution() const { return m_perlinRes; }
+	int getOctaves() const { return m_octaves; }
+
 private:
+	/// \brief berechnet alle Oktaven und beide Buffer neu (nach einer Änderung der Auflösung)
 	void regenerate();
-	void setHeight(int x, int z, float height);
+	/// \brief berechnet die fehlenden Oktaven, die Höhen und den Vertex-Buffer neu
+	void updateHeights();
 	int calcIndex(int x, int z) const;
-	void generate();
-	float perlinNoise(float x, float z);
+	/// \brief berechnet die Oktaven [firstOctave, m_octaves) und summiert alle Oktaven zu den Höhen
+	void generate(int firstOctave);
+	/// \brief berechnet die Gradienten-Caches für die Oktaven [firstOctave, m_octaves)
+	void buildLattices(int firstOctave);
+	/// \brief computes the heights of the rows [firstZ, lastZ)
+	void generateRows(int firstZ, int lastZ, int firstOctave);
+	float perlinNoise(float x, float z, glm::vec2* derivative = nullptr) const;
+	/// \brief Schlüssel der aktuellen Heightmap im Cache auf der Festplatte
+	HeightmapCache::Key getCacheKey() const;
 	void createVertexBuffer();
+	/// \brief packt die Normalen aus m_heightGradient (nur im beleuchteten Modus)
+	void createNormalBuffer();
+	void createCompactVertexBuffer();
+	/// \brief erzeugt die Gitter-Indizes der aktuellen Auflösung, falls sie noch nicht im Cache sind
+	void createIndexBuffer();
 	void switchOptions(bool increase);
 	void changeOptionValue(bool increase);
 
@@ -54,13 +109,67 @@ private:
 	int m_octaves;
 	float m_persistence;
 	float m_heightScale;
+	// Höhenskalierung beim Start (der Shader skaliert relativ dazu)
+	float m_initialHeightScale;
 
+	// unskalierte Höhen
 	std::vector<float> m_height;
+	// Ableitungen der unskalierten Höhen nach x und z im Gitter-Raum [-1, 1] (nur im beleuchteten Modus aktuell)
+	std::vector<glm::vec2> m_heightGradient;
+	// ungewichtetes Rauschen einer Oktave und seine Ableitungen nach den Sample-Koordinaten
+	struct Layer
+	{
+		std::vector<float> value;
+		std::vector<float> derivativeX;
+		std::vector<float> derivativeZ;
+	};
+	// Die ersten m_validLayers passen zu Auflösung und Perlin-Auflösung, auch wenn es mehr als m_octaves sind
+	std::vector<Layer> m_layers;
+	// haben alle gültigen Layer Ableitungen? (nur im beleuchteten Modus)
+	bool m_layerDerivatives = false;
+	int m_validLayers = 0;
+	// Perlin-Noise (Seed wie bisher mit Pseudorandom)
+	NoiseKernel m_noise = NoiseKernel(TERRAIN_SEED);
+	// Gradienten-Cache pro Oktave (leer, wenn das Gitter mehr Punkte als die Heightmap hätte)
+	std::vector<NoiseKernel::Lattice> m_lattices;
+	// Zeit der letzten Generierung (oder des Ladens aus dem Cache) in Millisekunden
+	float m_generateTime = 0.0f;
+	// Heightmaps auf der Festplatte, wiederverwendet über Programmstarts hinweg
+	HeightmapCache m_heightCache{ HEIGHTMAP_CACHE_DIRECTORY, HEIGHTMAP_CACHE_BYTES };
+	// kamen die aktuellen Höhen aus dem Cache?
+	bool m_heightsFromCache = false;
+
+	// Worker-Threads für die Generierung (Zeilenblöcke mit mindestens dieser Anzahl Zeilen)
+	std::unique_ptr<ThreadPool> m_threadPool;
+	static constexpr size_t s_generateChunkRows = 4;
+
 	VertexBuffer<glm::vec3> m_positions;
-	IndexBuffer m_indices;
+	// kompakter Modus: nur die Höhen, normalisiert auf [0, 65535] (6x weniger als vec3)
+	bool m_compactVertices = true;
+	VertexBuffer<GLushort> m_compactHeights;
+	// Minimum und Schrittweite der 16-Bit-Höhen
+	glm::vec2 m_heightRange = glm::vec2(0.0f);
+	// beleuchteter Modus: gepackte Normalen (4 Byte pro Vertex)
+	bool m_lit = false;
+	VertexBuffer<PackedSnorm3x10_1x2> m_normals;
+
+	// Gitter-Indizes pro Auflösung (Triangle-Strips mit Primitive Restart), hängen nur von m_resolution ab
+	struct GridIndices
+	{
+		// 16 Bit, solange alle Vertex-Indizes kleiner als der Restart-Index sind
+		bool use16Bit = false;
+		BasicIndexBuffer<uint16_t> indices16;
+		BasicIndexBuffer<uint32_t> indices32;
+	};
+	std::map<int, GridIndices> m_gridIndices;
 	VertexArrayObject m_vao;
 	Program m_program;
 
 	// Uniform für die Transformationsmatrix hinzufügen
 	Uniform<glm::mat4> m_uniformTransform;
+	Uniform<float> m_uniformHeightScale;
+	Uniform<GLint> m_uniformCompact;
+	Uniform<GLint> m_uniformResolution;
+	Uniform<glm::vec2> m_uniformHeightRange;
+	Uniform<GLint> m_uniformLit;
 };
@@ -5,6 +5,9 @@
 #include "../framework/error.h"
 #include "../framework/Timer.h"
 #include "Terrain.h"
+#include "ChunkedTerrain.h"
+#include "CdlodTerrain.h"
+#include <memory>
 
 using namespace glm;
 
@@ -14,6 +17,10 @@ static const int RES = 32;
 static const float PERLIN_RESOLUTION = 8.f;
 static const int OCTAVES = 4;
 static const float PERSISTANCE = 0.5f;
+// Threads für die Terrain-Generierung (0 = alle Kerne)
+static const size_t GENERATE_THREADS = 0;
+// Geschwindigkeitsstufe der Kamera im Chunk-Modus (Perlin-Einheiten pro Sekunde)
+static const float CAMERA_SPEED_STEP = 0.5f;
 
 int main()
 {
@@ -23,7 +30,20 @@ int main()
         Window wnd = Window(800, 600, "Hardware Renderer");
 
         // Terrain initialisieren
-        Terrain terrain = Terrain(RES, PERLIN_RESOLUTION, OCTAVES, PERSISTANCE, HEIGHT_SCALE);
+        Terrain terrain = Terrain(RES, PERLIN_RESOLUTION, OCTAVES, PERSISTANCE, HEIGHT_SCALE, GENERATE_THREADS);
+
+        // unendliches Terrain aus Chunks (Chunk-Modus), wird beim ersten Einschalten erzeugt (startet die Worker)
+        std::unique_ptr<ChunkedTerrain> chunks;
+        bool chunkMode = false;
+
+        // Quadtree-LOD (CDLOD-Modus), wird beim ersten Einschalten mit den aktuellen Optionen erzeugt
+        std::unique_ptr<CdlodTerrain> lodTerrain;
+        bool lodMode = false;
+
+        // Kamera pro Modus: im Chunk-Modus unbegrenzt in Perlin-Koordinaten, im CDLOD-Modus im Terrain-Raum [-1, 1]
+        glm::vec2 chunkCamera = glm::vec2(0.0f);
+        glm::vec2 lodCamera = glm::vec2(0.0f);
+        glm::vec2 cameraVelocity = glm::vec2(0.0f);
 
         // Variablen für die Transformation
         glm::mat4 terrainTransformation = glm::mat4(1.0f);
@@ -73,6 +93,54 @@ int main()
                 case Window::Key::E:
                     scaleValue *= 0.9f; // Verkleinern
                     break;
+                case Window::Key::V: // Kompakte Vertices (nur Höhen) an/aus
+                    terrain.setCompactVertices(!terrain.getCompactVertices());
+                    std::cout << (terrain.getCompactVertices() ? "\nKompakte Vertices (16-Bit-Hoehen)\n" : "\nVollstaendige Vertices (vec3)\n");
+                    terrain.outOptionString();
+                    break;
+                case Window::Key::N: // Beleuchtung mit Normalen aus den Rauschableitungen an/aus
+                    terrain.setLit(!terrain.getLit());
+                    std::cout << (terrain.getLit() ? "\nBeleuchtet (gefuellt)\n" : "\nDrahtgitter\n");
+                    terrain.outOptionString();
+                    break;
+                case Window::Key::C: // Chunk-Modus an/aus
+                    chunkMode = !chunkMode;
+                    lodMode = false;
+                    cameraVelocity = glm::vec2(0.0f);
+                    if (chunkMode && !chunks)
+                        chunks = std::make_unique<ChunkedTerrain>(ChunkedTerrain::Settings());
+                    std::cout << (chunkMode ? "\nChunk-Modus (unendliches Terrain)\n" : "\nEinzelnes Gitter\n");
+                    break;
+                case Window::Key::T: // CDLOD-Modus an/aus
+                    lodMode = !lodMode;
+                    chunkMode = false;
+                    cameraVelocity = glm::vec2(0.0f);
+                    // neu erzeugen, wenn sich die Optionen geändert haben
+                    if (lodMode && (!lodTerrain || lodTerrain->getPerlinResolution() != terrain.getPerlinResolution()
+                        || lodTerrain->getOctaves() != terrain.getOctaves()))
+                    {
+                        CdlodTerrain::Settings settings;
+                        settings.numThreads = GENERATE_THREADS;
+                        lodTerrain = std::make_unique<CdlodTerrain>(terrain.getPerlinResolution(), terrain.getOctaves(), settings);
+                    }
+                    std::cout << (lodMode ? "\nCDLOD-Modus (Quadtree-LOD)\n" : "\nEinzelnes Gitter\n");
+                    break;
+                // Kamera im Chunk- und CDLOD-Modus bewegen (jeder Tastendruck erhöht die Geschwindigkeit)
+                case Window::Key::I:
+                    cameraVelocity.y -= CAMERA_SPEED_STEP;
+                    break;
+                case Window::Key::K:
+                    cameraVelocity.y += CAMERA_SPEED_STEP;
+                    break;
+                case Window::Key::J:
+                    cameraVelocity.x -= CAMERA_SPEED_STEP;
+                    break;
+                case Window::Key::L:
+                    cameraVelocity.x += CAMERA_SPEED_STEP;
+                    break;
+                case Window::Key::SPACE:
+                    cameraVelocity = glm::vec2(0.0f);
+                    break;
 
                 default:
                     break;
@@ -96,6 +164,11 @@ int main()
         std::cout << "A/D: Rotation um die Y-Achse.\n";
         std::cout << "Z/X: Rotation um die Z-Achse.\n";
         std::cout << "Q/E: Vergrößern/Verkleinern des Terrains.\n";
+        std::cout << "V: Kompakte Vertices (nur Hoehen) an/aus.\n";
+        std::cout << "N: Beleuchtung (gefuellt, Normalen aus den Rauschableitungen) an/aus.\n";
+        std::cout << "C: Chunk-Modus (unendliches Terrain) an/aus.\n";
+        std::cout << "T: CDLOD-Modus (Quadtree-LOD) an/aus.\n";
+        std::cout << "I/J/K/L: Kamera im Chunk- und CDLOD-Modus beschleunigen, Leertaste: anhalten.\n";
         terrain.outOptionString();
 
         // OpenGL-Einstellungen
@@ -109,18 +182,40 @@ int main()
         // Hauptschleife
         while (wnd.isOpen())
         {
-            t.lap();
+            const float frameTime = t.lap();
 
             // Bildschirm löschen
             glClearColor(0.7f, 0.9f, 1.0f, 0.0f);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
             // Terrain zeichnen mit aktueller Transformation
-            terrain.draw(terrainTransformation);
+            std::string title = "Hardware Renderer | ";
+            if (chunkMode)
+            {
+                chunkCamera += cameraVelocity * (frameTime * 0.001f);
+                chunks->update(chunkCamera);
+                chunks->draw(terrainTransformation, terrain.getRelativeHeightScale());
+                title += std::to_string(chunks->getLoadedCount()) + " Chunks, " + std::to_string(chunks->getPendingCount()) + " ausstehend | ";
+            }
+            else if (lodMode)
+            {
+                // Kamera bleibt über dem Terrain
+                lodCamera = glm::clamp(lodCamera + cameraVelocity * (frameTime * 0.001f), -1.0f, 1.0f);
+                lodTerrain->update(lodCamera);
+                lodTerrain->draw(terrainTransformation, terrain.getRelativeHeightScale());
+                title += std::to_string(lodTerrain->getNodeCount()) + " Knoten, " + std::to_string(lodTerrain->getTriangleCount()) + " Dreiecke | ";
+            }
+            else
+            {
+                // beleuchtet gefüllt, sonst Wireframe
+                glPolygonMode(GL_FRONT_AND_BACK, terrain.getLit() ? GL_FILL : GL_LINE);
+                terrain.draw(terrainTransformation);
+                glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+            }
 
             // Fehlerüberprüfung
             glCheckError("main loop");
-            wnd.setTitle("Hardware Renderer | " + std::to_string(t.current()) + " ms");
+            wnd.setTitle(title + std::to_string(t.current()) + " ms");
 
             // Buffer tauschen und Ereignisse verarbeiten
             wnd.swapBuffer();
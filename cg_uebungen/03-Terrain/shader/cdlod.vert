@@ -0,0 +1,50 @@
+#version 330 core
+
+// CDLOD-Patch mit (u_gridSize + 1)^2 Vertices, x und z aus gl_VertexID (keine Vertex-Attribute)
+
+// Uniform für die Transformationsmatrix
+uniform mat4 u_transform;
+// Skalierung der Höhe (y)
+uniform float u_heightScale;
+// Heightmap (GL_R16) mit u_heightmapSize^2 Texeln über [-1, 1]^2
+uniform sampler2D u_heightmap;
+uniform int u_heightmapSize;
+// Minimum und Umfang der normalisierten Höhen
+uniform vec2 u_heightRange;
+// Knoten: xy = Ecke in Texeln, z = Kantenlänge in Texeln
+uniform vec3 u_node;
+uniform int u_gridSize;
+// Morph-Bereich des Levels (Abstand zum Auge im Terrain-Raum)
+uniform vec2 u_morphRange;
+// Auge im Terrain-Raum (x, Höhe, z)
+uniform vec3 u_camera;
+
+// terrain.frag erwartet eine Normale, der CDLOD-Modus ist nicht beleuchtet
+out vec3 v_normal;
+
+float heightAt(vec2 texel) {
+	return u_heightRange.x + texelFetch(u_heightmap, ivec2(texel), 0).r * u_heightRange.y;
+}
+
+vec2 toTerrain(vec2 texel) {
+	return texel / float(u_heightmapSize - 1) * 2.0 - 1.0;
+}
+
+void main(){
+	vec2 grid = vec2(gl_VertexID % (u_gridSize + 1), gl_VertexID / (u_gridSize + 1));
+	float texelsPerQuad = u_node.z / float(u_gridSize);
+	vec2 texel = u_node.xy + grid * texelsPerQuad;
+	float height = heightAt(texel);
+
+	// Morph: ungerade Vertices wandern mit dem Abstand auf ihren geraden Nachbarn,
+	// am Ende des Bereichs entspricht der Patch dem Gitter des nächsten Levels
+	vec2 pos = toTerrain(texel);
+	float morph = clamp((distance(u_camera, vec3(pos.x, height, pos.y)) - u_morphRange.x) / (u_morphRange.y - u_morphRange.x), 0.0, 1.0);
+	vec2 coarseTexel = texel - mod(grid, 2.0) * texelsPerQuad;
+	pos = toTerrain(mix(texel, coarseTexel, morph));
+	height = mix(height, heightAt(coarseTexel), morph);
+
+	// Vertausche y- und z-Komponente (wie terrain.vert)
+	gl_Position = u_transform * vec4(pos.x, pos.y, height * u_heightScale, 1.0);
+	v_normal = vec3(0.0);
+}
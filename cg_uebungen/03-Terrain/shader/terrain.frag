@@ -1,7 +1,20 @@
 #version 330 core
 
+// beleuchteter Modus: diffuses Licht aus fester Richtung
+uniform bool u_lit;
+
+in vec3 v_normal;
+
 out vec3 out_color;
 
+// Richtung zum Licht im Raum nach u_transform
+const vec3 lightDirection = normalize(vec3(0.3, 0.4, 0.85));
+
 void main(){
-	out_color = vec3(1.0); // Weiß
+	if (u_lit) {
+		float diffuse = max(dot(normalize(v_normal), lightDirection), 0.0);
+		out_color = vec3(0.45, 0.6, 0.3) * (0.25 + 0.75 * diffuse);
+	} else {
+		out_color = vec3(1.0); // Weiß
+	}
 }
@@ -1,12 +1,45 @@
 #version 330 core
 
 layout(location = 0) in vec3 in_pos;
+// kompakter Modus: nur die Höhe (0 bis 65535)
+layout(location = 1) in uint in_height;
+// beleuchteter Modus: Normale für Höhenskalierung 1 (gepackt, normalisiert)
+layout(location = 2) in vec4 in_normal;
 
 // Uniform für die Transformationsmatrix
 uniform mat4 u_transform;
+// Skalierung der Höhe (y)
+uniform float u_heightScale;
+// kompakter Modus: x und z aus dem Vertex-Index im Gitter mit u_resolution^2 Punkten
+uniform bool u_compact;
+uniform int u_resolution;
+// Minimum und Schrittweite der kompakten Höhen
+uniform vec2 u_heightRange;
+// beleuchteter Modus
+uniform bool u_lit;
+
+// Normale im Raum nach u_transform
+out vec3 v_normal;
 
 void main(){
+	vec3 pos = in_pos;
+	if (u_compact) {
+		// wie in Terrain::createVertexBuffer
+		float maxCoord = float(u_resolution - 1);
+		pos.x = ((float(gl_VertexID % u_resolution) / maxCoord) - 0.5) * 2.0;
+		pos.z = ((float(gl_VertexID / u_resolution) / maxCoord) - 0.5) * 2.0;
+		pos.y = u_heightRange.x + float(in_height) * u_heightRange.y;
+	}
+
 	// Vertausche y- und z-Komponente
-	vec4 position = vec4(in_pos.x, in_pos.z, in_pos.y, 1.0);
+	vec4 position = vec4(pos.x, pos.z, pos.y * u_heightScale, 1.0);
 	gl_Position = u_transform * position;
+
+	if (u_lit) {
+		// (-dh/dx, 1, -dh/dz) mit skalierter Höhe, vertauscht wie die Position
+		vec3 normal = vec3(in_normal.x * u_heightScale, in_normal.y, in_normal.z * u_heightScale);
+		v_normal = mat3(u_transform) * vec3(normal.x, normal.z, normal.y);
+	} else {
+		v_normal = vec3(0.0);
+	}
 }
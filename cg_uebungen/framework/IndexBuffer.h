@@ -1,12 +1,26 @@
 #pragma once
 #include "BufferBase.h"
+#include <limits>
 
-class IndexBuffer : public BufferBase<uint32_t, GL_ELEMENT_ARRAY_BUFFER>
+template<class TIndex>
+class BasicIndexBuffer : public BufferBase<TIndex, GL_ELEMENT_ARRAY_BUFFER>
 {
 public:
+	/// \brief index that restarts the primitive if primitive restart is enabled (largest value of the index type)
+	static constexpr TIndex RESTART_INDEX = std::numeric_limits<TIndex>::max();
+
 	/// \brief adds a new index to the buffer
-	void addIndex(uint32_t index)
+	void addIndex(TIndex index)
 	{
-		addElement(index);
+		this->addElement(index);
 	}
-};
\ No newline at end of file
+
+	/// \brief adds the restart index (e.g. starts a new triangle strip)
+	void addRestart()
+	{
+		const TIndex restart = RESTART_INDEX;
+		this->addElement(restart);
+	}
+};
+
+using IndexBuffer = BasicIndexBuffer<uint32_t>;
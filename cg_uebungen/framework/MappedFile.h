@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/// \brief read-only memory mapping of a whole file (mmap on POSIX, a file mapping on Windows).
+/// The data stays valid until the file is closed or the object is destroyed
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& m) noexcept
+	{
+		swap(m);
+	}
+	MappedFile& operator=(MappedFile&& m) noexcept
+	{
+		swap(m);
+		return *this;
+	}
+	void swap(MappedFile& o) noexcept
+	{
+		std::swap(m_data, o.m_data);
+		std::swap(m_size, o.m_size);
+#ifdef _WIN32
+		std::swap(m_file, o.m_file);
+		std::swap(m_mapping, o.m_mapping);
+#endif
+	}
+
+	/// \brief maps the file (a previously mapped file is closed)
+	/// \return false if the file does not exist, is empty or could not be mapped
+	bool open(const std::string& filename);
+
+	/// \brief unmaps the file
+	void close();
+
+	bool isOpen() const { return m_data != nullptr; }
+	const uint8_t* data() const { return m_data; }
+	/// \return size in bytes
+	size_t size() const { return m_size; }
+
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	// HANDLEs (windows.h is only included in the cpp)
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#endif
+};
@@ -90,6 +90,36 @@ void Texture2D::uploadToGpu()
 	glDebugError("Texture2D::uploadToGpu");
 }
 
+void Texture2D::uploadToGpu(GLsizei width, GLsizei height, const uint16_t* data)
+{
+	// delete old texture
+	dispose();
+
+	dassert(width > 0);
+	dassert(height > 0);
+
+	// no CPU copy (the caller owns the data)
+	m_data.clear();
+	m_width = width;
+	m_height = height;
+
+	glGenTextures(1, &m_id);
+	glBindTexture(GL_TEXTURE_2D, m_id);
+	// rows with an odd width are not 4 byte aligned (the previous alignment is restored afterwards)
+	GLint unpackAlignment = 4;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R16, m_width, m_height, 0, GL_RED, GL_UNSIGNED_SHORT, data);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glDebugError("Texture2D::uploadToGpu");
+}
+
 void Texture2D::bind(GLuint slot) const
 {
 	// was the texture data uploaded to the gpu?
@@ -50,6 +50,13 @@ public:
 	/// \brief creates a texture on gpu and uploads the data
 	void uploadToGpu();
 
+	/// \brief creates a single channel 16 bit texture (GL_R16, sampled as [0,1]) on gpu from external data.
+	/// The texture has no mipmaps, nearest filtering and clamps to the edge (meant for texelFetch)
+	/// \param width width in pixels
+	/// \param height height in pixels
+	/// \param data width * height values, row by row
+	void uploadToGpu(GLsizei width, GLsizei height, const uint16_t* data);
+
 	/// \brief binds a texture on the gpu
 	/// \param slot binding slot. Most gpus support slot 0 - 7. 0 - 31 are supported by the opengl API
 	void bind(GLuint slot) const;
@@ -0,0 +1,94 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+	if (numThreads == 0)
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	for (size_t i = 1; i < numThreads; ++i)
+		m_workers.emplace_back([this]() { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+	for (auto& w : m_workers)
+		w.join();
+}
+
+size_t ThreadPool::getChunkCount(size_t count, size_t minChunkSize) const
+{
+	if (count == 0)
+		return 0;
+
+	// a few chunks per thread for load balancing
+	const size_t maxChunks = getThreadCount() * 4;
+	const size_t chunks = (count + std::max<size_t>(minChunkSize, 1) - 1) / std::max<size_t>(minChunkSize, 1);
+	return std::min(chunks, maxChunks);
+}
+
+void ThreadPool::parallelFor(size_t count, size_t minChunkSize, const Job& job)
+{
+	const size_t numChunks = getChunkCount(count, minChunkSize);
+	if (numChunks == 0)
+		return;
+
+	if (numChunks == 1 || m_workers.empty())
+	{
+		// not worth waking the workers
+		for (size_t chunk = 0; chunk < numChunks; ++chunk)
+			job(chunk, getChunkBegin(count, numChunks, chunk), getChunkBegin(count, numChunks, chunk + 1));
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_job = &job;
+		m_count = count;
+		m_numChunks = numChunks;
+		m_nextChunk = 0;
+		m_busyWorkers = m_workers.size();
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	runChunks();
+
+	// wait for the chunks of the workers
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [this]() { return m_busyWorkers == 0; });
+	m_job = nullptr;
+}
+
+void ThreadPool::workerLoop()
+{
+	uint64_t generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [&]() { return m_quit || m_generation != generation; });
+			if (m_quit)
+				return;
+			generation = m_generation;
+		}
+
+		runChunks();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (--m_busyWorkers == 0)
+			m_done.notify_one();
+	}
+}
+
+void ThreadPool::runChunks()
+{
+	size_t chunk;
+	while ((chunk = m_nextChunk.fetch_add(1)) < m_numChunks)
+		(*m_job)(chunk, getChunkBegin(m_count, m_numChunks, chunk), getChunkBegin(m_count, m_numChunks, chunk + 1));
+}
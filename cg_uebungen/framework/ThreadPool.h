@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+/// \brief fixed set of worker threads for data parallel loops.
+/// The calling thread works on the chunks as well. parallelFor() must not be called from inside a job
+class ThreadPool
+{
+public:
+	/// \brief chunk job: (chunk index, first element, end element)
+	using Job = std::function<void(size_t, size_t, size_t)>;
+
+	/// \param numThreads number of threads including the calling thread (0 = hardware concurrency)
+	explicit ThreadPool(size_t numThreads = 0);
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// \return number of threads including the calling thread
+	size_t getThreadCount() const { return m_workers.size() + 1; }
+
+	/// \return number of chunks that parallelFor() uses for count elements (0 for count = 0)
+	size_t getChunkCount(size_t count, size_t minChunkSize) const;
+
+	/// \return first element of a chunk (the chunk ends at the beginning of the next chunk)
+	static size_t getChunkBegin(size_t count, size_t numChunks, size_t chunk) { return count * chunk / numChunks; }
+
+	/// \brief splits [0, count) into getChunkCount() contiguous chunks and runs the job for every chunk.
+	/// Blocks until all chunks are done. The chunk boundaries only depend on count, minChunkSize and the thread count
+	/// \param minChunkSize minimum number of elements per chunk (small loops run on the calling thread only)
+	void parallelFor(size_t count, size_t minChunkSize, const Job& job);
+private:
+	void workerLoop();
+	/// \brief runs chunks until all chunks are taken
+	void runChunks();
+private:
+	std::vector<std::thread> m_workers;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	uint64_t m_generation = 0;
+	size_t m_busyWorkers = 0;
+	bool m_quit = false;
+
+	// current loop
+	const Job* m_job = nullptr;
+	size_t m_count = 0;
+	size_t m_numChunks = 0;
+	std::atomic<size_t> m_nextChunk{ 0 };
+};
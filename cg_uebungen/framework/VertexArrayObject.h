@@ -70,6 +70,8 @@ public:
 
 		if (type == GL_FLOAT || type == GL_DOUBLE)
 			glVertexAttribPointer(location, count, type, GL_FALSE, 0, nullptr);
+		else if (type == GL_INT_2_10_10_10_REV) // packed formats are always read as normalized floats
+			glVertexAttribPointer(location, count, type, GL_TRUE, 0, nullptr);
 		else // upload integer as integer
 			glVertexAttribIPointer(location, count, type, 0, nullptr);
 
@@ -78,6 +80,16 @@ public:
 		glDebugError("VertexArrayObject::attachBuffer");
 	}
 
+	/// \brief disables a vertex attribute of this vertex array object (the shader reads the constant default value)
+	/// \param location in location of the vertex shader
+	void detachBuffer(GLuint location)
+	{
+		bind();
+		glDisableVertexAttribArray(location);
+
+		glDebugError("VertexArrayObject::detachBuffer");
+	}
+
 	/// \brief uses glDrawArrays to draw the attached buffers
 	/// \param mode draw mode e.g. GL_TRIANGLES, GL_LINES, GL_POINTS...
 	void drawArrays(GLenum mode, const Program& program) const
@@ -92,12 +104,21 @@ public:
 	/// \brief uses glDrawElements to draw the attached buffers
 	/// \param mode draw mode e.g. GL_TRIANGLES, GL_LINES, GL_POINTS...
 	/// \param indices the index buffer used to index the triangles
-	void drawElements(GLenum mode, const Program& program, const IndexBuffer& indices) const
+	/// \param primitiveRestart starts a new primitive at every BasicIndexBuffer::RESTART_INDEX (e.g. for GL_TRIANGLE_STRIP)
+	template<class TIndex>
+	void drawElements(GLenum mode, const Program& program, const BasicIndexBuffer<TIndex>& indices, bool primitiveRestart = false) const
 	{
 		program.bind();
 		bind(); // bind vao
 		indices.bind();
-		glDrawElements(mode, GLsizei(indices.getCount()), GL_UNSIGNED_INT, nullptr);
+		if (primitiveRestart)
+		{
+			glEnable(GL_PRIMITIVE_RESTART);
+			glPrimitiveRestartIndex(BasicIndexBuffer<TIndex>::RESTART_INDEX);
+		}
+		glDrawElements(mode, GLsizei(indices.getCount()), gltype::Type<TIndex>, nullptr);
+		if (primitiveRestart)
+			glDisable(GL_PRIMITIVE_RESTART);
 
 		glDebugError("VertexArrayObject::drawElements");
 	}
@@ -4,6 +4,12 @@
 #include <glad/glad.h>
 #include <glm/detail/func_common.hpp>
 #include <memory>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define WINDOW_SSE2
+#endif
 
 // required for the mouse and keyboard callbacks
 static Window* s_window = nullptr;
@@ -124,7 +130,13 @@ void Window::swapBuffer() const
 {
 #ifdef WINDOW_PUT_PIXEL
 	// update texture data
-	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, GLsizei(m_width), GLsizei(m_height), GL_RGB, GL_UNSIGNED_BYTE, m_pixels.data());
+	const uint8_t* pixels = m_pixels.data();
+	if (m_tiled)
+	{
+		detile();
+		pixels = m_linearPixels.data();
+	}
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, GLsizei(m_renderWidth), GLsizei(m_renderHeight), GL_RGB, GL_UNSIGNED_BYTE, pixels);
 	
 	// draw screenfilling quad
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -139,11 +151,12 @@ void Window::putPixel(int x, int y, uint8_t r, uint8_t g, uint8_t b)
 {
 	dassert(x >= 0);
 	dassert(y >= 0);
-	dassert(x < int(m_width));
-	dassert(y < int(m_height));
-	m_pixels[(y * m_width + x) * 3 + 0] = r;
-	m_pixels[(y * m_width + x) * 3 + 1] = g;
-	m_pixels[(y * m_width + x) * 3 + 2] = b;
+	dassert(x < int(m_renderWidth));
+	dassert(y < int(m_renderHeight));
+	const size_t offset = pixelOffset(x, y);
+	m_pixels[offset + 0] = r;
+	m_pixels[offset + 1] = g;
+	m_pixels[offset + 2] = b;
 }
 
 void Window::putPixel(int x, int y, float r, float g, float b)
@@ -151,17 +164,79 @@ void Window::putPixel(int x, int y, float r, float g, float b)
 	putPixel(x, y, convertToBits(r), convertToBits(g), convertToBits(b));
 }
 
+void Window::writeSpan(int y, int x0, int x1, const glm::vec3* colors)
+{
+	dassert(x0 >= 0);
+	dassert(y >= 0);
+	dassert(x0 <= x1);
+	dassert(x1 <= int(m_renderWidth));
+	dassert(y < int(m_renderHeight));
+	static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "vec3 must be tightly packed");
+	if (x0 == x1)
+		return;
+
+	// the span is converted channel by channel (rgb rgb ... matches the vec3 layout)
+	const float* src = &colors[0].x;
+	if (!m_tiled)
+	{
+		convertToBits(src, &m_pixels[pixelOffset(x0, y)], size_t(x1 - x0) * 3);
+		return;
+	}
+
+	// a tile row is contiguous => split the span at the tile borders
+	for (int x = x0; x < x1;)
+	{
+		const int end = std::min(x1, (x / TILE_SIZE + 1) * TILE_SIZE);
+		convertToBits(src + (x - x0) * 3, &m_pixels[pixelOffset(x, y)], size_t(end - x) * 3);
+		x = end;
+	}
+}
+
+void Window::fillSpan(int y, int x0, int x1, const glm::vec3& color)
+{
+	dassert(x0 >= 0);
+	dassert(y >= 0);
+	dassert(x0 <= x1);
+	dassert(x1 <= int(m_renderWidth));
+	dassert(y < int(m_renderHeight));
+	if (x0 == x1)
+		return;
+
+	const uint8_t rgb[3] = { convertToBits(color.r), convertToBits(color.g), convertToBits(color.b) };
+
+	// 16 pixels = 48 bytes, the pattern repeats without a seam
+	constexpr size_t blockPixels = 16;
+	uint8_t block[blockPixels * 3];
+	for (size_t i = 0; i < blockPixels; ++i)
+		memcpy(block + i * 3, rgb, 3);
+
+	// rows are contiguous in the linear layout, tile rows in the tiled layout
+	for (int x = x0; x < x1;)
+	{
+		const int end = m_tiled ? std::min(x1, (x / TILE_SIZE + 1) * TILE_SIZE) : x1;
+		uint8_t* dst = &m_pixels[pixelOffset(x, y)];
+		size_t count = size_t(end - x);
+
+		for (; count >= blockPixels; count -= blockPixels, dst += sizeof(block))
+			memcpy(dst, block, sizeof(block));
+		memcpy(dst, block, count * 3);
+		x = end;
+	}
+}
+
 void Window::initShader()
 {
 	Shader vertex(GL_VERTEX_SHADER);
 	vertex.loadFromSource(R"(
 	#version 330 core
+	out vec2 texcoord;
 	void main() {
 		vec4 vertex = vec4(0.0, 0.0, 0.0, 1.0);
 		if(uint(gl_VertexID) == 0u) vertex = vec4(1.0, -1.0, 0.0, 1.0);
 		if(uint(gl_VertexID) == 1u) vertex = vec4(-1.0, -1.0, 0.0, 1.0);
 		if(uint(gl_VertexID) == 2u) vertex = vec4(1.0, 1.0, 0.0, 1.0);
 		if(uint(gl_VertexID) == 3u) vertex = vec4(-1.0, 1.0, 0.0, 1.0);
+		texcoord = vertex.xy * 0.5 + 0.5;
 		gl_Position = vertex;
 	})");
 
@@ -169,9 +244,11 @@ void Window::initShader()
 	fragment.loadFromSource(R"(
 		#version 330 core
 		uniform sampler2D tex;
+		in vec2 texcoord;
 		out vec4 fragColor;
 		void main() {
-			fragColor = texelFetch(tex, ivec2(gl_FragCoord.xy), 0);
+			// the back buffer may be smaller than the window (upscaled by the texture filter)
+			fragColor = texture(tex, texcoord);
 	})");
 
 	m_program = std::make_unique<Program>();
@@ -188,10 +265,145 @@ void Window::clear()
 	memset(m_pixels.data(), 0, m_pixels.size() * sizeof(m_pixels[0]));
 }
 
+void Window::setTiledLayout(bool tiled)
+{
+	if (tiled == m_tiled)
+		return;
+
+	m_tiled = tiled;
+	allocatePixels();
+}
+
+#ifdef _DEBUG
+bool Window::testTiledLayout()
+{
+	const bool tiled = m_tiled;
+	const int width = int(m_renderWidth);
+	const int height = int(m_renderHeight);
+
+	// rows with varying span borders (partial tiles at both ends) and single pixels
+	std::vector<glm::vec3> colors(m_renderWidth);
+	auto drawPattern = [&]()
+	{
+		clear();
+		for (int y = 0; y < height; ++y)
+		{
+			const int x0 = std::min(y % 11, width);
+			const int x1 = std::max(x0, width - y % 7);
+			for (int x = x0; x < x1; ++x)
+				colors[x - x0] = glm::vec3(float(x) / float(width), float(y) / float(height), float((x * 7 + y * 13) % 256) / 255.0f);
+			if (y % 3 == 0)
+				fillSpan(y, x0, x1, glm::vec3(0.25f, float(y % 8) / 8.0f, 0.75f));
+			else
+				writeSpan(y, x0, x1, colors.data());
+			putPixel(width - 1 - y % width, y, 1.0f, 0.5f, 0.0f);
+		}
+	};
+
+	setTiledLayout(false);
+	drawPattern();
+	const std::vector<uint8_t> linear = m_pixels;
+
+	setTiledLayout(true);
+	drawPattern();
+	detile();
+	const bool equal = m_linearPixels == linear;
+
+	setTiledLayout(tiled);
+	clear();
+	return equal;
+}
+#endif
+
+void Window::allocatePixels()
+{
+	if (!m_tiled)
+	{
+		m_pixels.assign(m_renderWidth * m_renderHeight * 3, 0);
+		m_linearPixels.clear();
+		m_linearPixels.shrink_to_fit();
+		return;
+	}
+
+	// partial tiles at the right and top border are padded
+	m_tilesX = (m_renderWidth + TILE_SIZE - 1) / TILE_SIZE;
+	m_tilesY = (m_renderHeight + TILE_SIZE - 1) / TILE_SIZE;
+	m_pixels.assign(m_tilesX * m_tilesY * TILE_SIZE * TILE_SIZE * 3, 0);
+	m_linearPixels.resize(m_renderWidth * m_renderHeight * 3);
+}
+
+void Window::detile() const
+{
+	constexpr size_t tileRowBytes = TILE_SIZE * 3;
+	const size_t lastTileBytes = (m_renderWidth - (m_tilesX - 1) * TILE_SIZE) * 3;
+
+	for (size_t y = 0; y < m_renderHeight; ++y)
+	{
+		const uint8_t* src = &m_pixels[((y / TILE_SIZE) * m_tilesX * TILE_SIZE * TILE_SIZE + (y % TILE_SIZE) * TILE_SIZE) * 3];
+		uint8_t* dst = &m_linearPixels[y * m_renderWidth * 3];
+
+		// fixed size copies of one tile row (compiled to vector moves)
+		size_t tx = 0;
+		for (; tx + 1 < m_tilesX; ++tx)
+			memcpy(dst + tx * tileRowBytes, src + tx * TILE_SIZE * TILE_SIZE * 3, tileRowBytes);
+		memcpy(dst + tx * tileRowBytes, src + tx * TILE_SIZE * TILE_SIZE * 3, lastTileBytes);
+	}
+}
+
+void Window::setRenderResolution(size_t width, size_t height)
+{
+	width = std::max(size_t(1), std::min(width, m_width));
+	height = std::max(size_t(1), std::min(height, m_height));
+
+	if (!m_texture)
+		glGenTextures(1, &m_texture);
+	glBindTexture(GL_TEXTURE_2D, m_texture);
+
+	// (re)allocate texture with back buffer size
+	if (width != m_renderWidth || height != m_renderHeight)
+	{
+		m_renderWidth = width;
+		m_renderHeight = height;
+		allocatePixels();
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, GLsizei(m_renderWidth), GLsizei(m_renderHeight), 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+	}
+
+	// nearest filtering keeps the output pixel exact when no upscaling is needed
+	const GLint filter = (width == m_width && height == m_height) ? GL_NEAREST : GL_LINEAR;
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
 uint8_t Window::convertToBits(float r)
 {
 	return uint8_t(255.0f * glm::clamp(r, 0.0f, 1.0f));
 }
+
+void Window::convertToBits(const float* src, uint8_t* dst, size_t count)
+{
+	size_t i = 0;
+
+#ifdef WINDOW_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(255.0f);
+	// 16 channels per iteration => one 16 byte store
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i c0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 0), zero), one), scale));
+		__m128i c1 = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), zero), one), scale));
+		__m128i c2 = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 8), zero), one), scale));
+		__m128i c3 = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 12), zero), one), scale));
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(c0, c1), _mm_packs_epi32(c2, c3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+	}
+#endif
+
+	for (; i < count; ++i)
+		dst[i] = convertToBits(src[i]);
+}
 #endif
 
 void Window::setTitle(const std::string& title)
@@ -227,18 +439,8 @@ void Window::resize(size_t width, size_t height)
 	glViewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
 
 #ifdef WINDOW_PUT_PIXEL
-	m_pixels.resize(width * height * 3);
-
-	// generate texture with window size
-	if (m_texture)
-		glDeleteTextures(1, &m_texture);
-	
-	glGenTextures(1, &m_texture);
-	glBindTexture(GL_TEXTURE_2D, m_texture);
-	
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, GLsizei(m_width), GLsizei(m_height), 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	// back buffer starts with the full window size
+	setRenderResolution(width, height);
 #endif
 
 	if (m_onSizeChange)
@@ -7,6 +7,7 @@
 #include <functional>
 #include "Program.h"
 #include <memory>
+#include <glm/vec3.hpp>
 
 // windows likes to define some stuff
 #undef min
@@ -180,9 +181,52 @@ public:
 	/// \param b blue value [0,1]
 	void putPixel(int x, int y, float r, float g, float b);
 
+	/// \brief writes a horizontal run of pixels in the back buffer (will be visible after swapBuffer())
+	/// \param y pixel row
+	/// \param x0 first pixel (inclusive)
+	/// \param x1 last pixel (exclusive)
+	/// \param colors x1 - x0 colors with values in [0,1]
+	void writeSpan(int y, int x0, int x1, const glm::vec3* colors);
+
+	/// \brief fills a horizontal run of pixels in the back buffer with a single color
+	/// \param y pixel row
+	/// \param x0 first pixel (inclusive)
+	/// \param x1 last pixel (exclusive)
+	/// \param color color with values in [0,1]
+	void fillSpan(int y, int x0, int x1, const glm::vec3& color);
+
 	/// \brief sets all pixels to black
 	void clear();
 
+	/// \brief changes the resolution of the back buffer. The back buffer is upscaled to the window size on the gpu
+	/// \param width back buffer width in pixels (will be clamped to [1, window width])
+	/// \param height back buffer height in pixels (will be clamped to [1, window height])
+	void setRenderResolution(size_t width, size_t height);
+
+	/// \return back buffer width in pixels
+	size_t getRenderWidth() const { return m_renderWidth; }
+
+	/// \return back buffer height in pixels
+	size_t getRenderHeight() const { return m_renderHeight; }
+
+	/// \brief switches the back buffer between linear rows and 8x8 pixel tiles.
+	/// Tiles keep pixel blocks within a few cache lines and are converted to rows in swapBuffer()
+	/// \param tiled true for the tiled layout
+	void setTiledLayout(bool tiled);
+
+	/// \return true if the back buffer uses the tiled layout
+	bool isTiledLayout() const { return m_tiled; }
+
+#ifdef _DEBUG
+	/// \brief debug check: draws a test pattern with putPixel, writeSpan and fillSpan in both layouts and
+	/// compares the detiled back buffer with the linear one. The back buffer is cleared and the layout is kept
+	/// \return true if both layouts produce the same image
+	bool testTiledLayout();
+#endif
+
+	// edge length of a back buffer tile in pixels
+	static constexpr int TILE_SIZE = 8;
+
 #endif
 	/// \return window client width in pixels
 	size_t getWidth() const { return m_width; }
@@ -251,6 +295,28 @@ private:
 	/// \return converted color
 	static uint8_t convertToBits(float r);
 
+	/// \brief converts floating point colors channel by channel
+	/// \param src color channels in [0,1]
+	/// \param dst destination channels
+	/// \param count number of channels
+	static void convertToBits(const float* src, uint8_t* dst, size_t count);
+
+	/// \return byte offset of the pixel in m_pixels (depends on the memory layout)
+	size_t pixelOffset(int x, int y) const
+	{
+		if (!m_tiled)
+			return (y * m_renderWidth + x) * 3;
+
+		const size_t tile = size_t(y / TILE_SIZE) * m_tilesX + size_t(x / TILE_SIZE);
+		return (tile * TILE_SIZE * TILE_SIZE + size_t(y % TILE_SIZE) * TILE_SIZE + size_t(x % TILE_SIZE)) * 3;
+	}
+
+	/// \brief resizes the pixel buffers for the current render resolution and layout
+	void allocatePixels();
+
+	/// \brief converts the tiled back buffer into rows (m_linearPixels)
+	void detile() const;
+
 	void initShader();
 #endif
 
@@ -263,7 +329,14 @@ private:
 	size_t m_height = 0;
 
 #ifdef WINDOW_PUT_PIXEL
+	size_t m_renderWidth = 0;
+	size_t m_renderHeight = 0;
 	std::vector<uint8_t> m_pixels;
+	bool m_tiled = false;
+	size_t m_tilesX = 0;
+	size_t m_tilesY = 0;
+	// row major copy of a tiled back buffer (for the texture upload)
+	mutable std::vector<uint8_t> m_linearPixels;
 	std::unique_ptr<Program> m_program;
 	uint32_t m_vao = 0;
 	uint32_t m_texture = 0;
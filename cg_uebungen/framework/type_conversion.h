@@ -4,6 +4,13 @@
 
 // helper to convert some types
 
+/// \brief three normalized signed 10 bit components and one 2 bit component in 32 bits
+/// (GL_INT_2_10_10_10_REV, read as normalized vec4 in the shader), e.g. from glm::packSnorm3x10_1x2
+struct PackedSnorm3x10_1x2
+{
+	GLuint bits;
+};
+
 namespace gltype
 {
 	// if Type is equal to ErrorType it could not be translated
@@ -16,6 +23,7 @@ namespace gltype
 	template<> constexpr GLenum Type<GLushort> = GL_UNSIGNED_SHORT;
 	template<> constexpr GLenum Type<GLbyte> = GL_BYTE;
 	template<> constexpr GLenum Type<GLubyte> = GL_UNSIGNED_BYTE;
+	template<> constexpr GLenum Type<PackedSnorm3x10_1x2> = GL_INT_2_10_10_10_REV;
 	template<typename T> constexpr GLenum Type<glm::tvec1<T>> = Type<T>;
 	template<typename T> constexpr GLenum Type<glm::tvec2<T>> = Type<T>;
 	template<typename T> constexpr GLenum Type<glm::tvec3<T>> = Type<T>;
@@ -38,6 +46,7 @@ namespace gltype
 	template<> constexpr GLsizei NumComponents<GLushort> = 1;
 	template<> constexpr GLsizei NumComponents<GLbyte> = 1;
 	template<> constexpr GLsizei NumComponents<GLubyte> = 1;
+	template<> constexpr GLsizei NumComponents<PackedSnorm3x10_1x2> = 4;
 	template<typename T> constexpr GLsizei NumComponents<glm::tvec1<T>> = 1;
 	template<typename T> constexpr GLsizei NumComponents<glm::tvec2<T>> = 2;
 	template<typename T> constexpr GLsizei NumComponents<glm::tvec3<T>> = 3;